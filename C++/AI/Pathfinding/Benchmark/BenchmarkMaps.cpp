@@ -0,0 +1,315 @@
+#include <AI/Pathfinding/Benchmark/BenchmarkMaps.h>
+
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <utility>
+
+int BenchmarkMap::NumPassable() const
+{
+	int count = 0;
+
+	for (size_t i = 0; i < passable.size(); ++i) if (passable[i]) ++count;
+
+	return count;
+}
+
+bool BenchmarkMaps::LoadMovingAIMap(const char* a_fileName, BenchmarkMap& a_map)
+{
+	std::ifstream in(a_fileName);
+
+	if (!in)
+	{
+		return false;
+	}
+
+	//Header is "type octile", "height H", "width W", "map", in that order
+	std::string token;
+	int width = 0, height = 0;
+
+	while (in >> token && token != "map")
+	{
+		if (token == "height") in >> height;
+		else if (token == "width") in >> width;
+		else if (token == "type") in >> token;
+	}
+
+	if (width <= 0 || height <= 0)
+	{
+		return false;
+	}
+
+	a_map.name = a_fileName;
+	a_map.width = width;
+	a_map.height = height;
+	a_map.passable.assign(width * height, 0);
+
+	std::string row;
+	for (int y = 0; y < height && in >> row; ++y)
+	{
+		for (int x = 0; x < width && x < (int)row.size(); ++x)
+		{
+			char c = row[x];
+			a_map.passable[y * width + x] = (c == '.' || c == 'G' || c == 'S') ? 1 : 0;
+		}
+	}
+
+	return true;
+}
+
+bool BenchmarkMaps::LoadMovingAIScenario(const char* a_fileName, std::vector<BenchmarkQuery>& a_queries)
+{
+	std::ifstream in(a_fileName);
+
+	if (!in)
+	{
+		return false;
+	}
+
+	std::string line;
+	std::getline(in, line); //"version x"
+
+	while (std::getline(in, line))
+	{
+		std::istringstream ss(line);
+
+		int bucket, mapWidth, mapHeight;
+		std::string mapName;
+		BenchmarkQuery query;
+
+		if (ss >> bucket >> mapName >> mapWidth >> mapHeight >> query.startX >> query.startY >> query.goalX >> query.goalY >> query.optimalLength)
+		{
+			a_queries.push_back(query);
+		}
+	}
+
+	return true;
+}
+
+void BenchmarkMaps::GenerateOpenField(int a_width, int a_height, float a_obstacleDensity, unsigned int a_seed, BenchmarkMap& a_map)
+{
+	std::mt19937 rng(a_seed);
+	std::uniform_real_distribution<float> chance(0.f, 1.f);
+
+	std::ostringstream name;
+	name << "open_" << a_width << "x" << a_height;
+
+	a_map.name = name.str();
+	a_map.width = a_width;
+	a_map.height = a_height;
+	a_map.passable.assign(a_width * a_height, 1);
+
+	for (size_t i = 0; i < a_map.passable.size(); ++i)
+	{
+		if (chance(rng) < a_obstacleDensity)
+		{
+			a_map.passable[i] = 0;
+		}
+	}
+}
+
+void BenchmarkMaps::GenerateRooms(int a_width, int a_height, int a_roomSize, unsigned int a_seed, BenchmarkMap& a_map)
+{
+	std::mt19937 rng(a_seed);
+
+	std::ostringstream name;
+	name << "rooms_" << a_width << "x" << a_height;
+
+	a_map.name = name.str();
+	a_map.width = a_width;
+	a_map.height = a_height;
+	a_map.passable.assign(a_width * a_height, 1);
+
+	//Walls on every a_roomSize'th row and column
+	for (int y = 0; y < a_height; ++y)
+	{
+		for (int x = 0; x < a_width; ++x)
+		{
+			if ((x % a_roomSize) == a_roomSize - 1 || (y % a_roomSize) == a_roomSize - 1)
+			{
+				a_map.passable[y * a_width + x] = 0;
+			}
+		}
+	}
+
+	//Punch a door through each wall segment between two rooms
+	std::uniform_int_distribution<int> doorOffset(0, a_roomSize - 2);
+
+	for (int roomY = 0; roomY * a_roomSize < a_height; ++roomY)
+	{
+		for (int roomX = 0; roomX * a_roomSize < a_width; ++roomX)
+		{
+			int wallX = roomX * a_roomSize + a_roomSize - 1;
+			int wallY = roomY * a_roomSize + a_roomSize - 1;
+
+			int doorY = roomY * a_roomSize + doorOffset(rng);
+			if (wallX < a_width - 1 && doorY < a_height)
+			{
+				a_map.passable[doorY * a_width + wallX] = 1;
+			}
+
+			int doorX = roomX * a_roomSize + doorOffset(rng);
+			if (wallY < a_height - 1 && doorX < a_width)
+			{
+				a_map.passable[wallY * a_width + doorX] = 1;
+			}
+		}
+	}
+}
+
+void BenchmarkMaps::GenerateMaze(int a_width, int a_height, unsigned int a_seed, BenchmarkMap& a_map)
+{
+	std::mt19937 rng(a_seed);
+
+	std::ostringstream name;
+	name << "maze_" << a_width << "x" << a_height;
+
+	a_map.name = name.str();
+	a_map.width = a_width;
+	a_map.height = a_height;
+	a_map.passable.assign(a_width * a_height, 0);
+
+	//Recursive backtracker over the odd cells, carving the wall cell between each pair of visited cells
+	const int mazeWidth = (a_width - 1) / 2;
+	const int mazeHeight = (a_height - 1) / 2;
+
+	if (mazeWidth <= 0 || mazeHeight <= 0)
+	{
+		return;
+	}
+
+	std::vector<unsigned char> visited(mazeWidth * mazeHeight, 0);
+	std::vector<std::pair<int, int> > stack;
+	stack.reserve(mazeWidth * mazeHeight);
+
+	stack.push_back(std::make_pair(0, 0));
+	visited[0] = 1;
+	a_map.passable[1 * a_width + 1] = 1;
+
+	const int offsets[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+
+	while (!stack.empty())
+	{
+		int cx = stack.back().first;
+		int cy = stack.back().second;
+
+		int options[4];
+		int numOptions = 0;
+
+		for (int i = 0; i < 4; ++i)
+		{
+			int nx = cx + offsets[i][0];
+			int ny = cy + offsets[i][1];
+
+			if (nx >= 0 && ny >= 0 && nx < mazeWidth && ny < mazeHeight && !visited[ny * mazeWidth + nx])
+			{
+				options[numOptions++] = i;
+			}
+		}
+
+		if (numOptions == 0)
+		{
+			stack.pop_back();
+			continue;
+		}
+
+		int dir = options[std::uniform_int_distribution<int>(0, numOptions - 1)(rng)];
+		int nx = cx + offsets[dir][0];
+		int ny = cy + offsets[dir][1];
+
+		visited[ny * mazeWidth + nx] = 1;
+		a_map.passable[(2 * cy + 1 + offsets[dir][1]) * a_width + (2 * cx + 1 + offsets[dir][0])] = 1; //Wall between the cells
+		a_map.passable[(2 * ny + 1) * a_width + (2 * nx + 1)] = 1;
+
+		stack.push_back(std::make_pair(nx, ny));
+	}
+}
+
+void BenchmarkMaps::GenerateQueries(const BenchmarkMap& a_map, int a_numQueries, unsigned int a_seed, std::vector<BenchmarkQuery>& a_queries)
+{
+	//Label 8-connected components, matching the connectivity of the grids built by GraphGenerator
+	std::vector<int> component(a_map.passable.size(), -1);
+	std::vector<int> open;
+	int numComponents = 0;
+
+	for (int start = 0; start < (int)a_map.passable.size(); ++start)
+	{
+		if (!a_map.passable[start] || component[start] != -1)
+		{
+			continue;
+		}
+
+		component[start] = numComponents;
+		open.push_back(start);
+
+		while (!open.empty())
+		{
+			int cell = open.back();
+			open.pop_back();
+
+			int cx = cell % a_map.width;
+			int cy = cell / a_map.width;
+
+			for (int dy = -1; dy <= 1; ++dy)
+			{
+				for (int dx = -1; dx <= 1; ++dx)
+				{
+					int nx = cx + dx;
+					int ny = cy + dy;
+
+					if (nx < 0 || ny < 0 || nx >= a_map.width || ny >= a_map.height)
+					{
+						continue;
+					}
+
+					int neighbour = ny * a_map.width + nx;
+
+					if (a_map.passable[neighbour] && component[neighbour] == -1)
+					{
+						component[neighbour] = numComponents;
+						open.push_back(neighbour);
+					}
+				}
+			}
+		}
+
+		++numComponents;
+	}
+
+	std::vector<int> passableCells;
+	for (int i = 0; i < (int)a_map.passable.size(); ++i) if (a_map.passable[i]) passableCells.push_back(i);
+
+	if (passableCells.size() < 2)
+	{
+		return;
+	}
+
+	std::mt19937 rng(a_seed);
+	std::uniform_int_distribution<int> pick(0, (int)passableCells.size() - 1);
+
+	for (int q = 0; q < a_numQueries; ++q)
+	{
+		int start = passableCells[pick(rng)];
+		int goal = passableCells[pick(rng)];
+
+		//Resample the goal until it shares the start's component (bounded so tiny islands can't stall us)
+		for (int attempt = 0; attempt < 64 && (component[goal] != component[start] || goal == start); ++attempt)
+		{
+			goal = passableCells[pick(rng)];
+		}
+
+		if (component[goal] != component[start])
+		{
+			continue;
+		}
+
+		BenchmarkQuery query;
+		query.startX = start % a_map.width;
+		query.startY = start / a_map.width;
+		query.goalX = goal % a_map.width;
+		query.goalY = goal / a_map.width;
+		query.optimalLength = -1.f;
+
+		a_queries.push_back(query);
+	}
+}
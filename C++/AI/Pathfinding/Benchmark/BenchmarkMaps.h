@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+//Grid map used by the pathfinding benchmark. Cell (x, y) is stored at y * width + x, with y = 0 being the
+//top row, which matches the node indices produced by GraphGenerator::GenerateGrid.
+struct BenchmarkMap
+{
+	std::string name;
+	int width;
+	int height;
+	std::vector<unsigned char> passable;
+
+	BenchmarkMap() : width(0), height(0) {}
+
+	bool IsPassable(int a_x, int a_y) const { return passable[a_y * width + a_x] != 0; }
+	int CellIndex(int a_x, int a_y) const { return a_y * width + a_x; }
+	int NumPassable() const;
+};
+
+//A single start/goal pair, either read from a MovingAI .scen file or picked at random
+struct BenchmarkQuery
+{
+	int startX;
+	int startY;
+	int goalX;
+	int goalY;
+	float optimalLength; //As given by the scenario file, or -1 if unknown
+};
+
+class BenchmarkMaps
+{
+public:
+	//MovingAI benchmark formats (movingai.com/benchmarks). '.', 'G' and 'S' are passable, everything else is blocked.
+	static bool LoadMovingAIMap(const char* a_fileName, BenchmarkMap& a_map);
+	static bool LoadMovingAIScenario(const char* a_fileName, std::vector<BenchmarkQuery>& a_queries);
+
+	//Synthetic stand-ins for the MovingAI map sets, so the benchmark can run without downloading anything
+	static void GenerateOpenField(int a_width, int a_height, float a_obstacleDensity, unsigned int a_seed, BenchmarkMap& a_map);
+	static void GenerateRooms(int a_width, int a_height, int a_roomSize, unsigned int a_seed, BenchmarkMap& a_map);
+	static void GenerateMaze(int a_width, int a_height, unsigned int a_seed, BenchmarkMap& a_map);
+
+	//Picks random passable start/goal pairs that are connected (8-neighbour flood fill from the start)
+	static void GenerateQueries(const BenchmarkMap& a_map, int a_numQueries, unsigned int a_seed, std::vector<BenchmarkQuery>& a_queries);
+private:
+	BenchmarkMaps() {}
+};
@@ -0,0 +1,365 @@
+//Pathfinding benchmark. Runs the graph searches over MovingAI maps or synthetic open/rooms/maze grids and
+//writes ns/query, nodes expanded and peak heap use for every (map, algorithm) pair as JSON.
+//
+//Usage: PathfindingBenchmark [--map file.map --scen file.scen] [--sizes 64,128,256] [--queries N] [--flowfields N] [--seed N] [--reorder zorder|hilbert|rcm|bfs] [--out results.json]
+
+#include <AI/Pathfinding/Benchmark/BenchmarkMaps.h>
+
+#include <AI/Pathfinding/GraphEdge.h>
+#include <AI/Pathfinding/NodeNavigation.h>
+#include <AI/Pathfinding/SparseGraph.h>
+#include <AI/Pathfinding/GraphGenerator.h>
+#include <AI/Pathfinding/GraphOrdering.h>
+#include <AI/Pathfinding/GridMask.h>
+#include <AI/Pathfinding/Heuristics.h>
+#include <AI/Pathfinding/Graph_SearchAStar.h>
+#include <AI/Pathfinding/Graph_SearchDijkstra.h>
+#include <AI/Pathfinding/Graph_SearchBFS.h>
+#include <AI/Pathfinding/Graph_SearchDeltaStepping.h>
+#include <AI/Pathfinding/Graph_SearchFringe.h>
+#include <AI/Pathfinding/Grid_SearchAStar.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <new>
+#include <vector>
+
+typedef SparseGraph<NodeNavigation, GraphEdge> NavGraph;
+
+struct BenchmarkResult
+{
+	std::string mapName;
+	std::string algorithm;
+	int width;
+	int height;
+	int numQueries;
+	double nsPerQuery;
+	double nodesExpandedPerQuery;
+	size_t peakMemoryBytes; //Most heap in use during the run beyond what was in use before it
+};
+
+//Heap accounting through the global operator new/delete, so each run can report its own peak rather than the
+//process high-water mark. Every block carries its size in a header in front of it.
+namespace
+{
+	std::atomic<size_t> g_HeapInUse(0);
+	std::atomic<size_t> g_HeapPeak(0);
+
+	const size_t k_HeapHeader = 16; //Keeps the block after it 16-byte aligned
+
+	void* CountedAlloc(size_t a_size)
+	{
+		char* block = static_cast<char*>(std::malloc(a_size + k_HeapHeader));
+
+		if (!block)
+		{
+			throw std::bad_alloc();
+		}
+
+		*reinterpret_cast<size_t*>(block) = a_size;
+
+		const size_t inUse = g_HeapInUse.fetch_add(a_size) + a_size;
+		size_t peak = g_HeapPeak.load();
+
+		while (inUse > peak && !g_HeapPeak.compare_exchange_weak(peak, inUse))
+		{
+		}
+
+		return block + k_HeapHeader;
+	}
+
+	void CountedFree(void* a_pointer)
+	{
+		if (a_pointer)
+		{
+			char* block = static_cast<char*>(a_pointer) - k_HeapHeader;
+
+			g_HeapInUse.fetch_sub(*reinterpret_cast<size_t*>(block));
+			std::free(block);
+		}
+	}
+
+	//Starts a new peak from what is in use now and returns that as the baseline
+	size_t ResetHeapPeak()
+	{
+		const size_t inUse = g_HeapInUse.load();
+		g_HeapPeak.store(inUse);
+		return inUse;
+	}
+}
+
+void* operator new(size_t a_size) { return CountedAlloc(a_size); }
+void* operator new[](size_t a_size) { return CountedAlloc(a_size); }
+void operator delete(void* a_pointer) noexcept { CountedFree(a_pointer); }
+void operator delete[](void* a_pointer) noexcept { CountedFree(a_pointer); }
+void operator delete(void* a_pointer, size_t) noexcept { CountedFree(a_pointer); }
+void operator delete[](void* a_pointer, size_t) noexcept { CountedFree(a_pointer); }
+
+static void BuildMask(const BenchmarkMap& a_map, GridMask& a_mask)
+{
+	a_mask.Resize(a_map.width, a_map.height, false);
+
+	for (int y = 0; y < a_map.height; ++y)
+	{
+		for (int x = 0; x < a_map.width; ++x)
+		{
+			a_mask.SetWalkable(x, y, a_map.IsPassable(x, y));
+		}
+	}
+}
+
+//Builds an 8-connected grid graph with one node per cell.
+//Corner cutting stays allowed so the graph matches the 8-connected components GenerateQueries picks pairs from.
+static void BuildGraph(const GridMask& a_mask, NavGraph& a_graph)
+{
+	delete GraphGenerator<NavGraph, NodeNavigation, GraphEdge>::GenerateGridFromMask(&a_graph, a_mask, 1.f, 1.f, diagonal_always);
+}
+
+//Same neighbourhood and costs as BuildGraph, searched directly on the grid
+typedef Grid_SearchAStar<GridConnectivity<diagonal_always>, GridCost_Octile> GridAStar;
+
+//Delta-stepping is always a full single-source run, so it ignores the target RunQueries passes
+struct DeltaSteppingQuery
+{
+	DeltaSteppingQuery(const NavGraph& a_graph, int a_start, int) : search(a_graph, a_start) {}
+	int GetNodesSearched() const { return search.GetNodesSearched(); }
+
+	Graph_SearchDeltaStepping<NavGraph> search;
+};
+
+//Runs every query through search_type, which must take (space, start, target) and provide GetNodesSearched().
+//a_nodeOfCell translates cell indices for a reordered graph.
+template <class search_type, class space_type>
+static BenchmarkResult RunQueries(const char* a_algorithm, const BenchmarkMap& a_map, const space_type& a_space, const std::vector<BenchmarkQuery>& a_queries, bool a_singleSource,
+	const std::vector<int>* a_nodeOfCell = nullptr)
+{
+	long long nodesExpanded = 0;
+
+	const size_t heapBaseline = ResetHeapPeak();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (size_t q = 0; q < a_queries.size(); ++q)
+	{
+		const BenchmarkQuery& query = a_queries[q];
+
+		int startNode = a_map.CellIndex(query.startX, query.startY);
+		int goalNode = a_singleSource ? -1 : a_map.CellIndex(query.goalX, query.goalY);
+
+		if (a_nodeOfCell)
+		{
+			startNode = (*a_nodeOfCell)[startNode];
+			goalNode = goalNode < 0 ? goalNode : (*a_nodeOfCell)[goalNode];
+		}
+
+		search_type search(a_space, startNode, goalNode);
+		nodesExpanded += search.GetNodesSearched();
+	}
+
+	std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+	const size_t heapPeak = g_HeapPeak.load() - heapBaseline;
+
+	BenchmarkResult result;
+	result.mapName = a_map.name;
+	result.algorithm = a_algorithm;
+	result.width = a_map.width;
+	result.height = a_map.height;
+	result.numQueries = (int)a_queries.size();
+	result.nsPerQuery = a_queries.empty() ? 0.0 : (double)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / a_queries.size();
+	result.nodesExpandedPerQuery = a_queries.empty() ? 0.0 : (double)nodesExpanded / a_queries.size();
+	result.peakMemoryBytes = heapPeak;
+
+	return result;
+}
+
+//Node order for --reorder; empty keeps GraphGenerator's row-major order
+static std::vector<int> OrderGraph(const NavGraph& a_graph, const std::string& a_ordering)
+{
+	if (a_ordering == "zorder") return GraphOrdering::ZOrder(a_graph);
+	if (a_ordering == "hilbert") return GraphOrdering::Hilbert(a_graph);
+	if (a_ordering == "rcm") return GraphOrdering::ReverseCuthillMcKee(a_graph);
+	if (a_ordering == "bfs") return GraphOrdering::BreadthFirst(a_graph);
+	return std::vector<int>();
+}
+
+static void RunMap(const BenchmarkMap& a_map, const std::vector<BenchmarkQuery>& a_queries, int a_flowFieldSources, const std::string& a_ordering, std::vector<BenchmarkResult>& a_results)
+{
+	GridMask mask;
+	BuildMask(a_map, mask);
+
+	NavGraph graph(true);
+	BuildGraph(mask, graph);
+
+	//Grid graph nodes start out numbered by cell, so the ordering doubles as the cell to node table
+	const std::vector<int> nodeOfCell = OrderGraph(graph, a_ordering);
+	const std::vector<int>* graphNodes = nodeOfCell.empty() ? nullptr : &nodeOfCell;
+
+	if (graphNodes)
+	{
+		graph.Reorder(nodeOfCell);
+	}
+
+	PaddedGrid grid(mask);
+
+	a_results.push_back(RunQueries<Graph_SearchAStar<NavGraph, Heuristic_Euclidean> >("AStar", a_map, graph, a_queries, false, graphNodes));
+	//Heap against list frontier with the same heuristic; Fringe needs the octile one (see Graph_SearchFringe.h)
+	a_results.push_back(RunQueries<Graph_SearchAStar<NavGraph, Heuristic_Octile> >("AStarOctile", a_map, graph, a_queries, false, graphNodes));
+	a_results.push_back(RunQueries<Graph_SearchFringe<NavGraph, Heuristic_Octile> >("Fringe", a_map, graph, a_queries, false, graphNodes));
+	a_results.push_back(RunQueries<Graph_SearchDijkstra<NavGraph> >("Dijkstra", a_map, graph, a_queries, false, graphNodes));
+	a_results.push_back(RunQueries<Graph_SearchBFS<NavGraph> >("BFS", a_map, graph, a_queries, false, graphNodes));
+	a_results.push_back(RunQueries<GridAStar>("GridAStar", a_map, grid, a_queries, false));
+
+	//A flow field is a full single-source Dijkstra from the target (see Graph_FlowField::GenerateFlowFieldForNode).
+	//Graph_FlowField itself keeps N*N edge pointers, so it is measured through the search it runs.
+	std::vector<BenchmarkQuery> sources(a_queries.begin(), a_queries.begin() + std::min((int)a_queries.size(), a_flowFieldSources));
+	a_results.push_back(RunQueries<Graph_SearchDijkstra<NavGraph> >("FlowField", a_map, graph, sources, true, graphNodes));
+	a_results.push_back(RunQueries<DeltaSteppingQuery>("DeltaStepping", a_map, graph, sources, true, graphNodes));
+}
+
+static void WriteJson(std::ostream& a_os, const std::vector<BenchmarkResult>& a_results)
+{
+	a_os << "{\n  \"results\": [\n";
+
+	for (size_t i = 0; i < a_results.size(); ++i)
+	{
+		const BenchmarkResult& r = a_results[i];
+
+		a_os << "    { \"map\": \"" << r.mapName << "\", \"algorithm\": \"" << r.algorithm
+			<< "\", \"width\": " << r.width << ", \"height\": " << r.height
+			<< ", \"queries\": " << r.numQueries
+			<< ", \"ns_per_query\": " << r.nsPerQuery
+			<< ", \"nodes_expanded_per_query\": " << r.nodesExpandedPerQuery
+			<< ", \"peak_memory_bytes\": " << r.peakMemoryBytes << " }"
+			<< (i + 1 < a_results.size() ? ",\n" : "\n");
+	}
+
+	a_os << "  ]\n}\n";
+}
+
+int main(int argc, char** argv)
+{
+	const char* mapFile = nullptr;
+	const char* scenFile = nullptr;
+	const char* outFile = nullptr;
+	std::vector<int> sizes;
+	int numQueries = 100;
+	int flowFieldSources = 4;
+	unsigned int seed = 1;
+	std::string ordering;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		bool hasValue = i + 1 < argc;
+
+		if (!strcmp(argv[i], "--map") && hasValue) mapFile = argv[++i];
+		else if (!strcmp(argv[i], "--scen") && hasValue) scenFile = argv[++i];
+		else if (!strcmp(argv[i], "--out") && hasValue) outFile = argv[++i];
+		else if (!strcmp(argv[i], "--queries") && hasValue) numQueries = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--flowfields") && hasValue) flowFieldSources = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--seed") && hasValue) seed = (unsigned int)atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--reorder") && hasValue) ordering = argv[++i];
+		else if (!strcmp(argv[i], "--sizes") && hasValue)
+		{
+			for (const char* s = argv[++i]; *s; )
+			{
+				sizes.push_back(atoi(s));
+				while (*s && *s != ',') ++s;
+				if (*s == ',') ++s;
+			}
+		}
+		else
+		{
+			std::cerr << "Unknown argument: " << argv[i] << std::endl;
+			return 1;
+		}
+	}
+
+	if (!ordering.empty() && ordering != "zorder" && ordering != "hilbert" && ordering != "rcm" && ordering != "bfs")
+	{
+		std::cerr << "Unknown ordering: " << ordering << std::endl;
+		return 1;
+	}
+
+	if (sizes.empty())
+	{
+		sizes.push_back(64);
+		sizes.push_back(128);
+		sizes.push_back(256);
+	}
+
+	std::vector<BenchmarkResult> results;
+
+	if (mapFile)
+	{
+		BenchmarkMap map;
+		std::vector<BenchmarkQuery> queries;
+
+		if (!BenchmarkMaps::LoadMovingAIMap(mapFile, map))
+		{
+			std::cerr << "Cannot load map: " << mapFile << std::endl;
+			return 1;
+		}
+
+		if (scenFile)
+		{
+			if (!BenchmarkMaps::LoadMovingAIScenario(scenFile, queries))
+			{
+				std::cerr << "Cannot load scenario: " << scenFile << std::endl;
+				return 1;
+			}
+
+			if ((int)queries.size() > numQueries)
+			{
+				queries.resize(numQueries);
+			}
+		}
+		else
+		{
+			BenchmarkMaps::GenerateQueries(map, numQueries, seed, queries);
+		}
+
+		RunMap(map, queries, flowFieldSources, ordering, results);
+	}
+	else
+	{
+		for (size_t s = 0; s < sizes.size(); ++s)
+		{
+			BenchmarkMap maps[3];
+			BenchmarkMaps::GenerateOpenField(sizes[s], sizes[s], 0.1f, seed, maps[0]);
+			BenchmarkMaps::GenerateRooms(sizes[s], sizes[s], 16, seed, maps[1]);
+			BenchmarkMaps::GenerateMaze(sizes[s], sizes[s], seed, maps[2]);
+
+			for (int m = 0; m < 3; ++m)
+			{
+				std::vector<BenchmarkQuery> queries;
+				BenchmarkMaps::GenerateQueries(maps[m], numQueries, seed, queries);
+
+				RunMap(maps[m], queries, flowFieldSources, ordering, results);
+			}
+		}
+	}
+
+	if (outFile)
+	{
+		std::ofstream out(outFile);
+
+		if (!out)
+		{
+			std::cerr << "Cannot open file: " << outFile << std::endl;
+			return 1;
+		}
+
+		WriteJson(out, results);
+	}
+	else
+	{
+		WriteJson(std::cout, results);
+	}
+
+	return 0;
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+//Returns the number of set bits in a 64 bit word
+inline int PopCount64(uint64_t a_word)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+	return (int)__popcnt64(a_word);
+#elif defined(__GNUC__)
+	return __builtin_popcountll(a_word);
+#else
+	int count = 0;
+	for (; a_word; a_word &= a_word - 1) ++count;
+	return count;
+#endif
+}
+
+//Returns the index of the lowest set bit in a 64 bit word (word must be non-zero)
+inline int FindFirstSet64(uint64_t a_word)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+	unsigned long index;
+	_BitScanForward64(&index, a_word);
+	return (int)index;
+#elif defined(__GNUC__)
+	return __builtin_ctzll(a_word);
+#else
+	int index = 0;
+	while (!(a_word & 1ull)) { a_word >>= 1; ++index; }
+	return index;
+#endif
+}
+
+//Dense, growable set of bits stored in 64 bit words. Used for node flags (active, visited etc.)
+//where a vector of ints or bools would waste memory bandwidth.
+class Bitset
+{
+public:
+	enum { npos = -1 };
+
+	Bitset() : m_NumBits(0) {}
+	explicit Bitset(int a_numBits, bool a_value = false) : m_NumBits(0) { Resize(a_numBits, a_value); }
+
+	int Size() const { return m_NumBits; }
+	int NumWords() const { return (int)m_Words.size(); }
+	const uint64_t* Words() const { return m_Words.empty() ? nullptr : &m_Words[0]; }
+	uint64_t* Words() { return m_Words.empty() ? nullptr : &m_Words[0]; }
+
+	bool Test(int a_bit) const { return (m_Words[a_bit >> 6] >> (a_bit & 63)) & 1ull; }
+	void Set(int a_bit) { m_Words[a_bit >> 6] |= (1ull << (a_bit & 63)); }
+	void Reset(int a_bit) { m_Words[a_bit >> 6] &= ~(1ull << (a_bit & 63)); }
+
+	//Sets the bit and returns true if it was previously clear
+	bool TestAndSet(int a_bit)
+	{
+		uint64_t& word = m_Words[a_bit >> 6];
+		const uint64_t mask = 1ull << (a_bit & 63);
+		const bool wasClear = (word & mask) == 0;
+		word |= mask;
+		return wasClear;
+	}
+
+	void Resize(int a_numBits, bool a_value = false);
+	void PushBack(bool a_value) { Resize(m_NumBits + 1, a_value); }
+	void Clear() { m_Words.clear(); m_NumBits = 0; }
+
+	void SetAll();
+	void ResetAll() { for (size_t i = 0; i < m_Words.size(); ++i) m_Words[i] = 0; }
+
+	int Count() const; //Number of set bits
+	bool Any() const;
+
+	int FindFirst() const { return FindNext(0); }
+	int FindNext(int a_fromBit) const; //Returns the first set bit at or after a_fromBit, or npos
+
+private:
+	void ClearUnusedBits();
+
+	std::vector<uint64_t> m_Words;
+	int m_NumBits;
+};
+
+inline void Bitset::Resize(int a_numBits, bool a_value)
+{
+	const int oldBits = m_NumBits;
+
+	m_Words.resize((a_numBits + 63) >> 6, a_value ? ~0ull : 0ull);
+	m_NumBits = a_numBits;
+
+	//the tail of the previously last word was kept clear, so fill it if growing with set bits
+	if (a_value && a_numBits > oldBits && (oldBits & 63))
+	{
+		m_Words[oldBits >> 6] |= ~0ull << (oldBits & 63);
+	}
+
+	ClearUnusedBits();
+}
+
+inline void Bitset::SetAll()
+{
+	for (size_t i = 0; i < m_Words.size(); ++i) m_Words[i] = ~0ull;
+
+	ClearUnusedBits();
+}
+
+inline int Bitset::Count() const
+{
+	int count = 0;
+
+	for (size_t i = 0; i < m_Words.size(); ++i) count += PopCount64(m_Words[i]);
+
+	return count;
+}
+
+inline bool Bitset::Any() const
+{
+	for (size_t i = 0; i < m_Words.size(); ++i) if (m_Words[i]) return true;
+
+	return false;
+}
+
+inline int Bitset::FindNext(int a_fromBit) const
+{
+	if (a_fromBit >= m_NumBits) return npos;
+
+	int wordIndex = a_fromBit >> 6;
+	uint64_t word = m_Words[wordIndex] & (~0ull << (a_fromBit & 63)); //Mask off bits below the start
+
+	while (!word)
+	{
+		if (++wordIndex >= (int)m_Words.size()) return npos;
+
+		word = m_Words[wordIndex];
+	}
+
+	return (wordIndex << 6) + FindFirstSet64(word);
+}
+
+inline void Bitset::ClearUnusedBits()
+{
+	//keep bits past the end clear so Count and FindNext never report them
+	if (m_NumBits & 63)
+	{
+		m_Words.back() &= ~(~0ull << (m_NumBits & 63));
+	}
+}
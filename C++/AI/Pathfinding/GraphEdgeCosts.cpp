@@ -0,0 +1,88 @@
+#include <AI/Pathfinding/GraphEdgeCosts.h>
+
+#include <DirectXMath.h>
+
+#include <algorithm>
+
+void GraphEdgeCosts::CopyFrom(const float* a_costs)
+{
+	std::copy(a_costs, a_costs + NumEdges(), m_Costs.begin());
+}
+
+void GraphEdgeCosts::Scale(const GraphEdgeCosts& a_base, float a_factor)
+{
+	using namespace DirectX;
+
+	assert(SharesLayout(a_base) && "<GraphEdgeCosts::Scale>: base is from another graph");
+
+	const XMVECTOR factor = XMVectorReplicate(a_factor);
+	const float* base = a_base.Data();
+	float* costs = m_Costs.data();
+
+	//Both arrays are padded, so this runs over whole blocks only
+	for (int e = 0; e < NumEdges(); e += 4)
+	{
+		const XMVECTOR scaled = XMVectorMultiply(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(base + e)), factor);
+
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(costs + e), scaled);
+	}
+}
+
+void GraphEdgeCosts::Multiply(const GraphEdgeCosts& a_base, const float* a_factors)
+{
+	using namespace DirectX;
+
+	assert(SharesLayout(a_base) && "<GraphEdgeCosts::Multiply>: base is from another graph");
+
+	const float* base = a_base.Data();
+	float* costs = m_Costs.data();
+	const int blockEnd = NumEdges() & ~3; //a_factors is not padded
+	int e = 0;
+
+	for (; e < blockEnd; e += 4)
+	{
+		const XMVECTOR product = XMVectorMultiply(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(base + e)), XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(a_factors + e)));
+
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(costs + e), product);
+	}
+
+	for (; e < NumEdges(); ++e)
+	{
+		costs[e] = base[e] * a_factors[e];
+	}
+}
+
+//Per node: the node's own multiplier is the same for its whole edge range, and the far ends' are gathered four at a time
+void GraphEdgeCosts::ScaleByNode(const GraphEdgeCosts& a_base, const float* a_nodeMultipliers)
+{
+	using namespace DirectX;
+
+	assert(SharesLayout(a_base) && "<GraphEdgeCosts::ScaleByNode>: base is from another graph");
+
+	const Layout& layout = *m_Layout;
+	const float* base = a_base.Data();
+	float* costs = m_Costs.data();
+	const XMVECTOR half = XMVectorReplicate(0.5f);
+
+	for (int n = 0; n < NumNodes(); ++n)
+	{
+		const int end = layout.firstEdge[n + 1];
+		const XMVECTOR from = XMVectorReplicate(a_nodeMultipliers[n]);
+		int e = layout.firstEdge[n];
+
+		for (; e + 4 <= end; e += 4)
+		{
+			const int* to = &layout.to[e];
+			const XMFLOAT4 toMultipliers(a_nodeMultipliers[to[0]], a_nodeMultipliers[to[1]], a_nodeMultipliers[to[2]], a_nodeMultipliers[to[3]]);
+			const XMVECTOR mean = XMVectorMultiply(XMVectorAdd(from, XMLoadFloat4(&toMultipliers)), half);
+			const XMVECTOR scaled = XMVectorMultiply(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(base + e)), mean);
+
+			XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(costs + e), scaled);
+		}
+
+		for (; e < end; ++e)
+		{
+			costs[e] = base[e] * 0.5f * (a_nodeMultipliers[n] + a_nodeMultipliers[layout.to[e]]);
+		}
+	}
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <cassert>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+//Edge costs held outside the graph as one flat float array, numbered in the order the graph's edge iterators visit
+//them: node by node, and within a node in list order. Node n's edges are [FirstEdge(n), FirstEdge(n + 1)).
+//
+//Rewriting costs is then a pass over a flat array rather than a SetEdgeCost per edge, each a scan of the node's edge
+//list. The whole-array operations run four edges at a time with DirectXMath. The edge numbering (which edge goes where)
+//is shared between copies, so one set per faction or per unit type costs a float per edge and nothing more. Searches
+//read a set through EdgeCost_Array; it stays valid while the graph's edges are neither added nor removed.
+class GraphEdgeCosts
+{
+public:
+	//Numbers the graph's edges and copies their current costs
+	template <class graph_type>
+	explicit GraphEdgeCosts(const graph_type& a_graph);
+
+	int NumNodes() const { return (int)m_Layout->firstEdge.size() - 1; }
+	int NumEdges() const { return m_Layout->numEdges; }
+	int FirstEdge(int a_node) const { return m_Layout->firstEdge[a_node]; }
+	int EdgeTo(int a_edge) const { return m_Layout->to[a_edge]; }
+	bool SharesLayout(const GraphEdgeCosts& a_other) const { return m_Layout == a_other.m_Layout; }
+
+	float operator[](int a_edge) const { return m_Costs[a_edge]; }
+	float& operator[](int a_edge) { return m_Costs[a_edge]; }
+	const float* Data() const { return m_Costs.data(); }
+
+	//Costs from a per-edge array in edge order (e.g. another cost layer, or InfluenceMap::CaptureEdgeCosts)
+	void CopyFrom(const float* a_costs);
+	//Cost = base * a_factor
+	void Scale(const GraphEdgeCosts& a_base, float a_factor);
+	//Cost = base * a_factors[edge]
+	void Multiply(const GraphEdgeCosts& a_base, const float* a_factors);
+	//Cost = base * the mean of the multipliers at the edge's two ends, as GridCost_Terrain does for cells
+	void ScaleByNode(const GraphEdgeCosts& a_base, const float* a_nodeMultipliers);
+
+	//Cost = a_function(from, to, cost) for every edge, in order
+	template <class function>
+	void Rewrite(function a_function);
+
+	//Rereads the costs from the graph, or writes them back into it for searches reading Edge::Cost()
+	template <class graph_type>
+	void Capture(const graph_type& a_graph);
+	template <class graph_type>
+	void ApplyTo(graph_type& a_graph) const;
+private:
+	struct Layout
+	{
+		std::vector<int> firstEdge; //One per node plus one past the last edge
+		std::vector<int> to;
+		int numEdges;
+	};
+
+	//Arrays are padded to a multiple of four edges so the SIMD passes have no tail to handle
+	static int PaddedSize(int a_numEdges) { return (a_numEdges + 3) & ~3; }
+
+	std::shared_ptr<const Layout> m_Layout;
+	std::vector<float> m_Costs;
+};
+
+//Cost policies for the searches' cost_type template parameter. A search calls FirstEdge once per expanded node, then
+//for each edge Allows with the node it leads to (false skips the edge) and Cost with the edge's number, counting up
+//from FirstEdge. See GridClearance.h for a policy that filters by agent size.
+
+//The costs stored on the edges themselves (the default)
+struct EdgeCost_Graph
+{
+	int FirstEdge(int) const { return 0; }
+	bool Allows(int) const { return true; }
+	template <class edge_type>
+	float Cost(const edge_type& a_edge, int) const { return (float)a_edge.Cost(); }
+};
+
+//The costs in a GraphEdgeCosts built from the graph being searched
+class EdgeCost_Array
+{
+public:
+	EdgeCost_Array(const GraphEdgeCosts& a_costs) : m_Costs(&a_costs) {}
+
+	int FirstEdge(int a_node) const { return m_Costs->FirstEdge(a_node); }
+	bool Allows(int) const { return true; }
+	template <class edge_type>
+	float Cost(const edge_type&, int a_edge) const { return (*m_Costs)[a_edge]; }
+private:
+	const GraphEdgeCosts* m_Costs;
+};
+
+//Costs from a callback, for costs too expensive to precompute for every edge (line of fire, hazard sampling, ...). An
+//edge's cost is asked for the first time a search relaxes it and remembered for the rest of the query, keyed by edge,
+//so the graph must not change in between. Copies share the remembered costs: give each query its own policy, and read
+//NumEvaluations from it afterwards. The callback is a_function(from, to, stored cost) and returns the cost to use.
+//Graph_SearchLazyWeightedAStar defers evaluation further, and relies on the stored cost being a lower bound.
+template <class function>
+class EdgeCost_Lazy
+{
+public:
+	explicit EdgeCost_Lazy(function a_function) : m_Memo(new Memo(a_function)) {}
+
+	int FirstEdge(int) const { return 0; }
+	bool Allows(int) const { return true; }
+	template <class edge_type>
+	float Cost(const edge_type& a_edge, int) const;
+	template <class edge_type>
+	bool IsEvaluated(const edge_type& a_edge) const { return m_Memo->costs.count(&a_edge) != 0; }
+
+	int NumEvaluations() const { return (int)m_Memo->costs.size(); }
+	void Clear() { m_Memo->costs.clear(); } //Forgets every cost, for reuse on another query
+private:
+	struct Memo
+	{
+		Memo(function a_function) : costOf(a_function) {}
+
+		function costOf;
+		std::unordered_map<const void*, float> costs; //By edge
+	};
+
+	std::shared_ptr<Memo> m_Memo;
+};
+
+//Spares spelling out the callback's type, e.g. auto costs = MakeLazyEdgeCost([&](int a_from, int a_to, float a_cost) { ... });
+template <class function>
+EdgeCost_Lazy<function> MakeLazyEdgeCost(function a_function)
+{
+	return EdgeCost_Lazy<function>(a_function);
+}
+
+template <class graph_type>
+GraphEdgeCosts::GraphEdgeCosts(const graph_type& a_graph)
+{
+	std::shared_ptr<Layout> layout(new Layout);
+	layout->firstEdge.resize(a_graph.NumNodes() + 1);
+
+	for (int n = 0; n < a_graph.NumNodes(); ++n)
+	{
+		layout->firstEdge[n] = (int)layout->to.size();
+
+		typename graph_type::ConstEdgeIterator ConstEdgeItr(a_graph, n);
+
+		for (const typename graph_type::EdgeType* pE = ConstEdgeItr.begin(); !ConstEdgeItr.end(); pE = ConstEdgeItr.next())
+		{
+			layout->to.push_back(pE->To());
+		}
+	}
+
+	layout->numEdges = (int)layout->to.size();
+	layout->firstEdge[a_graph.NumNodes()] = layout->numEdges;
+	layout->to.resize(PaddedSize(layout->numEdges), 0); //Padding edges lead to node 0 and are never read back
+
+	m_Layout = layout;
+	m_Costs.assign(PaddedSize(layout->numEdges), 0.f);
+
+	Capture(a_graph);
+}
+
+template <class function>
+void GraphEdgeCosts::Rewrite(function a_function)
+{
+	const Layout& layout = *m_Layout;
+
+	for (int n = 0; n < NumNodes(); ++n)
+	{
+		for (int e = layout.firstEdge[n]; e < layout.firstEdge[n + 1]; ++e)
+		{
+			m_Costs[e] = a_function(n, layout.to[e], m_Costs[e]);
+		}
+	}
+}
+
+template <class graph_type>
+void GraphEdgeCosts::Capture(const graph_type& a_graph)
+{
+	assert(a_graph.NumNodes() == NumNodes() && "<GraphEdgeCosts::Capture>: graph has changed");
+
+	int edge = 0;
+
+	for (int n = 0; n < a_graph.NumNodes(); ++n)
+	{
+		typename graph_type::ConstEdgeIterator ConstEdgeItr(a_graph, n);
+
+		for (const typename graph_type::EdgeType* pE = ConstEdgeItr.begin(); !ConstEdgeItr.end(); pE = ConstEdgeItr.next())
+		{
+			m_Costs[edge++] = (float)pE->Cost();
+		}
+	}
+
+	assert(edge == NumEdges() && "<GraphEdgeCosts::Capture>: graph has changed");
+}
+
+template <class graph_type>
+void GraphEdgeCosts::ApplyTo(graph_type& a_graph) const
+{
+	assert(a_graph.NumNodes() == NumNodes() && "<GraphEdgeCosts::ApplyTo>: graph has changed");
+
+	int edge = 0;
+
+	for (int n = 0; n < a_graph.NumNodes(); ++n)
+	{
+		typename graph_type::EdgeIterator EdgeItr(a_graph, n);
+
+		for (typename graph_type::EdgeType* pE = EdgeItr.begin(); !EdgeItr.end(); pE = EdgeItr.next())
+		{
+			pE->SetCost(m_Costs[edge++]);
+		}
+	}
+
+	assert(edge == NumEdges() && "<GraphEdgeCosts::ApplyTo>: graph has changed");
+}
+
+template <class function>
+template <class edge_type>
+float EdgeCost_Lazy<function>::Cost(const edge_type& a_edge, int) const
+{
+	std::unordered_map<const void*, float>::const_iterator known = m_Memo->costs.find(&a_edge);
+
+	if (known != m_Memo->costs.end())
+	{
+		return known->second;
+	}
+
+	const float cost = (float)m_Memo->costOf(a_edge.From(), a_edge.To(), (float)a_edge.Cost());
+	m_Memo->costs[&a_edge] = cost;
+
+	return cost;
+}
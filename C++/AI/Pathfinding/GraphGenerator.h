@@ -2,6 +2,7 @@
 
 #include <DirectXMath.h>
 
+#include <AI/Pathfinding/GridMask.h>
 #include <AI/Pathfinding/GridValues.h>
 
 #include <vector>
@@ -14,6 +15,11 @@ public:
 	typedef node_type NodeType;
 
 	static GridValues* GenerateGrid(graph_type * a_graph, float a_mapWidth, float a_mapHeight, float a_cellResolutionWidth, float a_cellResolutionHeight, bool a_diagonalMovementAllowed = true);
+
+	//Builds a grid straight from a walkability mask in a single pass over the cells: blocked cells keep their slot (so
+	//node index is still y * width + x) but are never connected. Edge costs are in cells: 1 orthogonally, sqrt(2)
+	//diagonally, scaled by the average terrain cost multiplier of the two cells when the mask has a cost layer.
+	static GridValues* GenerateGridFromMask(graph_type * a_graph, const GridMask& a_mask, float a_cellResolutionWidth, float a_cellResolutionHeight, DiagonalMovement a_diagonalRule = diagonal_both_sides_open);
 private:
 	GraphGenerator() {}
 };
@@ -121,3 +127,84 @@ GridValues* GraphGenerator<graph_type, node_type, edge_type>::GenerateGrid(graph
 
 	return gridProperties;
 }
+
+template<class graph_type, class node_type, class edge_type>
+GridValues* GraphGenerator<graph_type, node_type, edge_type>::GenerateGridFromMask(graph_type * a_graph, const GridMask& a_mask, float a_cellResolutionWidth, float a_cellResolutionHeight, DiagonalMovement a_diagonalRule)
+{
+	const int numCellsWidth = a_mask.Width();
+	const int numCellsHeight = a_mask.Height();
+	const float diagonalCost = 1.41421356f;
+
+	GridValues * gridProperties = new GridValues();
+	gridProperties->mapWidth = numCellsWidth * a_cellResolutionWidth;
+	gridProperties->mapHeight = numCellsHeight * a_cellResolutionHeight;
+	gridProperties->cellResolutionWidth = a_cellResolutionWidth;
+	gridProperties->cellResolutionHeight = a_cellResolutionHeight;
+	gridProperties->diagonalMovementAllowed = a_diagonalRule != diagonal_never;
+	gridProperties->numCellsWidth = numCellsWidth;
+	gridProperties->numCellsHeight = numCellsHeight;
+
+	a_graph->Clear();
+	a_graph->SetDigraph(true);
+	a_graph->Reserve(numCellsWidth * numCellsHeight);
+
+	DirectX::XMFLOAT3 pos;
+	pos.y = 0.f;
+
+	NodeType node(0);
+	EdgeType edge;
+
+	//Connects the current cell to an earlier neighbour in both directions
+	auto connect = [&](int a_x, int a_y, int a_nx, int a_ny, float a_stepCost)
+	{
+		const float cost = a_mask.HasCosts() ? a_stepCost * 0.5f * (a_mask.GetCostMultiplier(a_x, a_y) + a_mask.GetCostMultiplier(a_nx, a_ny)) : a_stepCost;
+		const int from = a_mask.CellIndex(a_x, a_y);
+		const int to = a_mask.CellIndex(a_nx, a_ny);
+
+		edge.SetFromToCost(from, to, cost);
+		a_graph->AddEdge(edge);
+		edge.SetFromToCost(to, from, cost);
+		a_graph->AddEdge(edge);
+	};
+
+	for (int y = 0; y < numCellsHeight; ++y)
+	{
+		pos.z = gridProperties->mapHeight - (y + 0.5f) * a_cellResolutionHeight;
+
+		for (int x = 0; x < numCellsWidth; ++x)
+		{
+			pos.x = (x + 0.5f) * a_cellResolutionWidth;
+
+			node.SetIndex(a_mask.CellIndex(x, y));
+			node.SetPosition(pos);
+
+			if (!a_mask.IsWalkable(x, y))
+			{
+				a_graph->AddPlaceholderNode(node); //Kept off the free list, so no later AddNode takes a cell's index
+				continue;
+			}
+
+			a_graph->AddNode(node);
+
+			//Only look back at neighbours that already exist: left, top-left, top and top-right
+			if (a_mask.IsWalkable(x - 1, y))
+			{
+				connect(x, y, x - 1, y, 1.f);
+			}
+			if (a_mask.IsWalkable(x, y - 1))
+			{
+				connect(x, y, x, y - 1, 1.f);
+			}
+			if (a_mask.CanMoveDiagonal(x, y, -1, -1, a_diagonalRule))
+			{
+				connect(x, y, x - 1, y - 1, diagonalCost);
+			}
+			if (a_mask.CanMoveDiagonal(x, y, 1, -1, a_diagonalRule))
+			{
+				connect(x, y, x + 1, y - 1, diagonalCost);
+			}
+		}
+	}
+
+	return gridProperties;
+}
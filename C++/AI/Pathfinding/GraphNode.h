@@ -18,4 +18,10 @@ public:
 protected:
 	int m_Index;
 	int m_PreviousIndex;
-};
\ No newline at end of file
+};
+
+//Free save function used by SparseGraph::Save. Node types without a vtable (see NavGraphTypes.h) provide their own overload.
+inline void SaveNode(std::ostream& a_os, const GraphNode& a_node)
+{
+	a_node.SaveNode(a_os);
+}
\ No newline at end of file
@@ -0,0 +1,372 @@
+#pragma once
+
+#include <AI/Pathfinding/NodeTypeEnumerations.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+//Node orderings for SparseGraph::Reorder and VersionedGraph::Reorder. Each returns newIndexOfOld for every node slot:
+//active nodes take the first indices in the chosen order and removed slots follow in their old order. Nodes close in
+//the order are close in memory, so a search working through a neighbourhood touches fewer cache lines.
+//
+//  std::vector<int> oldIndexOfNew = graph.Reorder(GraphOrdering::Hilbert(graph));
+class GraphOrdering
+{
+public:
+	//Space-filling curves over the node positions (x, z), for grids and other spatially laid out graphs. Coordinates
+	//are ranked rather than scaled, so any grid spacing works. Hilbert keeps runs of the order more compact; Z-order is
+	//cheaper to compute.
+	template <class graph_type>
+	static std::vector<int> ZOrder(const graph_type& a_graph);
+	template <class graph_type>
+	static std::vector<int> Hilbert(const graph_type& a_graph);
+
+	//Reverse Cuthill-McKee, for any graph: each component is walked breadth first from a low degree node on its rim,
+	//visiting neighbours in increasing degree, and the whole order is reversed. Keeps the index gap along edges small.
+	template <class graph_type>
+	static std::vector<int> ReverseCuthillMcKee(const graph_type& a_graph);
+
+	//Breadth-first order from a_start, then from the lowest unvisited node of each remaining component
+	template <class graph_type>
+	static std::vector<int> BreadthFirst(const graph_type& a_graph, int a_start = 0);
+
+	//Turns newIndexOfOld into oldIndexOfNew and back
+	static std::vector<int> Invert(const std::vector<int>& a_order)
+	{
+		std::vector<int> inverse(a_order.size());
+
+		for (int n = 0; n < (int)a_order.size(); ++n)
+		{
+			inverse[a_order[n]] = n;
+		}
+
+		return inverse;
+	}
+private:
+	GraphOrdering() {}
+
+	//Active nodes in visiting order to newIndexOfOld
+	static std::vector<int> FromSequence(const std::vector<int>& a_sequence, int a_numNodes)
+	{
+		std::vector<int> order(a_numNodes, invalid_node_index);
+		int next = 0;
+
+		for (size_t i = 0; i < a_sequence.size(); ++i)
+		{
+			order[a_sequence[i]] = next++;
+		}
+
+		for (int n = 0; n < a_numNodes; ++n)
+		{
+			if (order[n] == invalid_node_index)
+			{
+				order[n] = next++;
+			}
+		}
+
+		return order;
+	}
+
+	//Spreads the low 32 bits of a_value to the even bits of the result
+	static uint64_t SpreadBits(uint32_t a_value)
+	{
+		uint64_t v = a_value;
+		v = (v | (v << 16)) & 0x0000FFFF0000FFFFull;
+		v = (v | (v << 8)) & 0x00FF00FF00FF00FFull;
+		v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0Full;
+		v = (v | (v << 2)) & 0x3333333333333333ull;
+		v = (v | (v << 1)) & 0x5555555555555555ull;
+		return v;
+	}
+
+	static uint64_t MortonKey(uint32_t a_x, uint32_t a_y, uint32_t) { return SpreadBits(a_x) | (SpreadBits(a_y) << 1); }
+
+	//Distance along the Hilbert curve filling an a_size x a_size square (a_size a power of two)
+	static uint64_t HilbertKey(uint32_t a_x, uint32_t a_y, uint32_t a_size)
+	{
+		uint64_t key = 0;
+
+		for (uint32_t s = a_size >> 1; s > 0; s >>= 1)
+		{
+			const uint32_t rx = (a_x & s) ? 1 : 0;
+			const uint32_t ry = (a_y & s) ? 1 : 0;
+
+			key += (uint64_t)s * s * ((3 * rx) ^ ry);
+
+			//Rotate the quadrant so the curve inside it runs the right way
+			if (ry == 0)
+			{
+				if (rx == 1)
+				{
+					a_x = a_size - 1 - a_x;
+					a_y = a_size - 1 - a_y;
+				}
+
+				std::swap(a_x, a_y);
+			}
+		}
+
+		return key;
+	}
+
+	template <class graph_type>
+	static std::vector<int> CurveOrder(const graph_type& a_graph, uint64_t (*a_key)(uint32_t, uint32_t, uint32_t));
+
+	template <class graph_type>
+	static int Degree(const graph_type& a_graph, int a_node)
+	{
+		int degree = 0;
+		typename graph_type::ConstEdgeIterator ConstEdgeItr(a_graph, a_node);
+
+		for (ConstEdgeItr.begin(); !ConstEdgeItr.end(); ConstEdgeItr.next())
+		{
+			++degree;
+		}
+
+		return degree;
+	}
+
+	//Breadth-first search over nodes not yet in a_done, marking levels with a_stamp. Returns the lowest degree node of
+	//the last level and its depth in a_depth.
+	template <class graph_type>
+	static int FarthestNode(const graph_type& a_graph, int a_start, const std::vector<int>& a_degree, const std::vector<char>& a_done,
+		std::vector<int>& a_mark, int a_stamp, std::vector<int>& a_queue, int& a_depth);
+};
+
+template <class graph_type>
+std::vector<int> GraphOrdering::CurveOrder(const graph_type& a_graph, uint64_t (*a_key)(uint32_t, uint32_t, uint32_t))
+{
+	std::vector<int> nodes;
+	std::vector<float> xs;
+	std::vector<float> zs;
+
+	for (int n = 0; n < a_graph.NumNodes(); ++n)
+	{
+		if (a_graph.isNodePresent(n))
+		{
+			nodes.push_back(n);
+			xs.push_back(a_graph.GetNode(n).GetPositionF3().x);
+			zs.push_back(a_graph.GetNode(n).GetPositionF3().z);
+		}
+	}
+
+	std::vector<float> columns(xs);
+	std::vector<float> rows(zs);
+	std::sort(columns.begin(), columns.end());
+	std::sort(rows.begin(), rows.end());
+	columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+	rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+	uint32_t size = 1;
+
+	while (size < columns.size() || size < rows.size())
+	{
+		size <<= 1;
+	}
+
+	std::vector<std::pair<uint64_t, int> > keys(nodes.size());
+
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		const uint32_t x = (uint32_t)(std::lower_bound(columns.begin(), columns.end(), xs[i]) - columns.begin());
+		const uint32_t y = (uint32_t)(std::lower_bound(rows.begin(), rows.end(), zs[i]) - rows.begin());
+
+		keys[i] = std::make_pair(a_key(x, y, size), nodes[i]);
+	}
+
+	std::sort(keys.begin(), keys.end());
+
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		nodes[i] = keys[i].second;
+	}
+
+	return FromSequence(nodes, a_graph.NumNodes());
+}
+
+template <class graph_type>
+std::vector<int> GraphOrdering::ZOrder(const graph_type& a_graph)
+{
+	return CurveOrder(a_graph, &MortonKey);
+}
+
+template <class graph_type>
+std::vector<int> GraphOrdering::Hilbert(const graph_type& a_graph)
+{
+	return CurveOrder(a_graph, &HilbertKey);
+}
+
+template <class graph_type>
+int GraphOrdering::FarthestNode(const graph_type& a_graph, int a_start, const std::vector<int>& a_degree, const std::vector<char>& a_done,
+	std::vector<int>& a_mark, int a_stamp, std::vector<int>& a_queue, int& a_depth)
+{
+	a_queue.clear();
+	a_queue.push_back(a_start);
+	a_mark[a_start] = a_stamp;
+	a_depth = 0;
+
+	size_t levelBegin = 0;
+
+	while (true)
+	{
+		const size_t levelEnd = a_queue.size();
+
+		for (size_t i = levelBegin; i < levelEnd; ++i)
+		{
+			typename graph_type::ConstEdgeIterator ConstEdgeItr(a_graph, a_queue[i]);
+
+			for (const typename graph_type::EdgeType* pE = ConstEdgeItr.begin(); !ConstEdgeItr.end(); pE = ConstEdgeItr.next())
+			{
+				if (a_mark[pE->To()] != a_stamp && !a_done[pE->To()] && a_graph.isNodePresent(pE->To()))
+				{
+					a_mark[pE->To()] = a_stamp;
+					a_queue.push_back(pE->To());
+				}
+			}
+		}
+
+		if (a_queue.size() == levelEnd)
+		{
+			//levelBegin .. levelEnd is the last level
+			int best = a_queue[levelBegin];
+
+			for (size_t i = levelBegin + 1; i < levelEnd; ++i)
+			{
+				if (a_degree[a_queue[i]] < a_degree[best])
+				{
+					best = a_queue[i];
+				}
+			}
+
+			return best;
+		}
+
+		levelBegin = levelEnd;
+		++a_depth;
+	}
+}
+
+template <class graph_type>
+std::vector<int> GraphOrdering::ReverseCuthillMcKee(const graph_type& a_graph)
+{
+	const int numNodes = a_graph.NumNodes();
+
+	std::vector<int> degree(numNodes, 0);
+	std::vector<int> byDegree;
+
+	for (int n = 0; n < numNodes; ++n)
+	{
+		if (a_graph.isNodePresent(n))
+		{
+			degree[n] = Degree(a_graph, n);
+			byDegree.push_back(n);
+		}
+	}
+
+	std::stable_sort(byDegree.begin(), byDegree.end(), [&degree](int a_a, int a_b) { return degree[a_a] < degree[a_b]; });
+
+	std::vector<char> done(numNodes, 0);
+	std::vector<int> mark(numNodes, 0);
+	std::vector<int> queue;
+	std::vector<int> sequence;
+	std::vector<int> neighbours;
+	int stamp = 0;
+
+	sequence.reserve(byDegree.size());
+
+	for (size_t c = 0; c < byDegree.size(); ++c)
+	{
+		if (done[byDegree[c]])
+		{
+			continue;
+		}
+
+		//Pseudo-peripheral start: keep jumping to the far side of the component while that makes it deeper
+		int start = byDegree[c];
+		int depth = 0;
+		int next = FarthestNode(a_graph, start, degree, done, mark, ++stamp, queue, depth);
+
+		for (int tries = 0; tries < 8; ++tries)
+		{
+			int nextDepth = 0;
+			const int candidate = FarthestNode(a_graph, next, degree, done, mark, ++stamp, queue, nextDepth);
+
+			if (nextDepth <= depth)
+			{
+				break;
+			}
+
+			start = next;
+			next = candidate;
+			depth = nextDepth;
+		}
+
+		size_t head = sequence.size();
+		sequence.push_back(start);
+		done[start] = 1;
+
+		for (; head < sequence.size(); ++head)
+		{
+			neighbours.clear();
+
+			typename graph_type::ConstEdgeIterator ConstEdgeItr(a_graph, sequence[head]);
+
+			for (const typename graph_type::EdgeType* pE = ConstEdgeItr.begin(); !ConstEdgeItr.end(); pE = ConstEdgeItr.next())
+			{
+				if (!done[pE->To()] && a_graph.isNodePresent(pE->To()))
+				{
+					done[pE->To()] = 1;
+					neighbours.push_back(pE->To());
+				}
+			}
+
+			std::stable_sort(neighbours.begin(), neighbours.end(), [&degree](int a_a, int a_b) { return degree[a_a] < degree[a_b]; });
+			sequence.insert(sequence.end(), neighbours.begin(), neighbours.end());
+		}
+	}
+
+	std::reverse(sequence.begin(), sequence.end());
+
+	return FromSequence(sequence, numNodes);
+}
+
+template <class graph_type>
+std::vector<int> GraphOrdering::BreadthFirst(const graph_type& a_graph, int a_start)
+{
+	const int numNodes = a_graph.NumNodes();
+
+	std::vector<char> done(numNodes, 0);
+	std::vector<int> sequence;
+	sequence.reserve(a_graph.NumActiveNodes());
+
+	for (int root = -1; root < numNodes; ++root)
+	{
+		const int start = root < 0 ? a_start : root;
+
+		if (start < 0 || start >= numNodes || done[start] || !a_graph.isNodePresent(start))
+		{
+			continue;
+		}
+
+		size_t head = sequence.size();
+		sequence.push_back(start);
+		done[start] = 1;
+
+		for (; head < sequence.size(); ++head)
+		{
+			typename graph_type::ConstEdgeIterator ConstEdgeItr(a_graph, sequence[head]);
+
+			for (const typename graph_type::EdgeType* pE = ConstEdgeItr.begin(); !ConstEdgeItr.end(); pE = ConstEdgeItr.next())
+			{
+				if (!done[pE->To()] && a_graph.isNodePresent(pE->To()))
+				{
+					done[pE->To()] = 1;
+					sequence.push_back(pE->To());
+				}
+			}
+		}
+	}
+
+	return FromSequence(sequence, numNodes);
+}
@@ -0,0 +1,345 @@
+#pragma once
+
+#include <AI/Pathfinding/Bitset.h>
+#include <AI/Pathfinding/NodeTypeEnumerations.h>
+
+#include <climits>
+#include <vector>
+
+//Unweighted traversal engine. Snapshots the graph's adjacency (forward and reverse) into flat arrays once, then runs
+//any number of traversals without allocating: visited and frontier sets are dense bitsets, the BFS queue and DFS stack
+//are sized to the graph up front. Call Rebuild() after editing the graph.
+//
+//Visitors are called as a_visitor(node, parent, depth) when a node is first reached (parent is invalid_node_index for
+//the start node) and return false to end the traversal early.
+template <class graph_type>
+class GraphTraversal
+{
+public:
+	explicit GraphTraversal(const graph_type& graph);
+
+	void Rebuild();
+
+	//Direction-optimising BFS: expands the frontier top-down while it is small and switches to bottom-up (every
+	//unvisited node looks for a parent among its in-neighbours) while it covers a large share of the remaining edges.
+	//Nodes are reached in non-decreasing depth; within one depth the order depends on the direction used.
+	//Returns the number of nodes reached.
+	template <class visitor_type>
+	int BreadthFirst(int a_start, visitor_type a_visitor, int a_maxDepth = INT_MAX);
+
+	//Iterative depth-first traversal in preorder on a preallocated explicit stack. Returns the number of nodes reached.
+	template <class visitor_type>
+	int DepthFirst(int a_start, visitor_type a_visitor);
+
+	//Pure queries, no parent tracking
+	bool IsReachable(int a_from, int a_to);
+	int HopDistance(int a_from, int a_to); //-1 if unreachable
+	int CountReachable(int a_start);
+	void HopDistances(int a_start, std::vector<int>& a_hops, int a_maxHops = INT_MAX); //-1 for nodes not reached
+
+	//Nodes reached by the last traversal
+	const Bitset& GetVisited() const { return m_Visited; }
+private:
+	//Beamer's switching thresholds
+	static const int k_TopDownToBottomUp = 14; //Go bottom-up once frontier edges exceed unexplored edges / 14
+	static const int k_BottomUpToTopDown = 24; //Go back top-down once the frontier is smaller than nodes / 24
+
+	struct StackEntry
+	{
+		int node;
+		int nextEdge;
+	};
+
+	const graph_type& m_Graph;
+
+	std::vector<int> m_OutStart; //CSR out edges: targets of node n are m_OutTarget[m_OutStart[n] .. m_OutStart[n + 1])
+	std::vector<int> m_OutTarget;
+	std::vector<int> m_InStart; //CSR in edges, for bottom-up steps
+	std::vector<int> m_InSource;
+
+	Bitset m_Visited;
+	Bitset m_Frontier;
+	std::vector<int> m_Queue; //Every reached node in BFS order; each level is a contiguous slice
+	std::vector<StackEntry> m_Stack;
+};
+
+template<class graph_type>
+GraphTraversal<graph_type>::GraphTraversal(const graph_type& graph)
+	: m_Graph(graph)
+{
+	Rebuild();
+}
+
+template<class graph_type>
+void GraphTraversal<graph_type>::Rebuild()
+{
+	typedef typename graph_type::EdgeType Edge;
+
+	const int numNodes = m_Graph.NumNodes();
+
+	m_OutStart.assign(numNodes + 1, 0);
+	m_InStart.assign(numNodes + 1, 0);
+	m_OutTarget.clear();
+
+	for (int n = 0; n < numNodes; ++n)
+	{
+		typename graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, n);
+
+		for (const Edge* edge = ConstEdgeItr.begin(); !ConstEdgeItr.end(); edge = ConstEdgeItr.next())
+		{
+			m_OutTarget.push_back(edge->To());
+			++m_InStart[edge->To() + 1];
+		}
+
+		m_OutStart[n + 1] = (int)m_OutTarget.size();
+	}
+
+	for (int n = 0; n < numNodes; ++n)
+	{
+		m_InStart[n + 1] += m_InStart[n];
+	}
+
+	//Scatter each edge into its target's in-list, using a copy of the starts as insert positions
+	std::vector<int> insertAt(m_InStart.begin(), m_InStart.end() - 1);
+	m_InSource.resize(m_OutTarget.size());
+
+	for (int n = 0; n < numNodes; ++n)
+	{
+		for (int e = m_OutStart[n]; e < m_OutStart[n + 1]; ++e)
+		{
+			m_InSource[insertAt[m_OutTarget[e]]++] = n;
+		}
+	}
+
+	m_Visited.Resize(numNodes);
+	m_Frontier.Resize(numNodes);
+	m_Queue.resize(numNodes);
+	m_Stack.resize(numNodes);
+}
+
+template<class graph_type>
+template<class visitor_type>
+int GraphTraversal<graph_type>::BreadthFirst(int a_start, visitor_type a_visitor, int a_maxDepth)
+{
+	const int numNodes = (int)m_Queue.size();
+
+	m_Visited.ResetAll();
+
+	if (a_start < 0 || a_start >= numNodes)
+	{
+		return 0;
+	}
+
+	m_Visited.Set(a_start);
+	m_Queue[0] = a_start;
+
+	int levelBegin = 0;
+	int levelEnd = 1;
+	int queueEnd = 1;
+
+	if (!a_visitor(a_start, invalid_node_index, 0))
+	{
+		return queueEnd;
+	}
+
+	long long unexploredEdges = (long long)m_OutTarget.size();
+	bool bottomUp = false;
+
+	for (int depth = 1; depth <= a_maxDepth && levelBegin < levelEnd; ++depth)
+	{
+		//Pick the direction for this level from the size of the frontier
+		long long frontierEdges = 0;
+
+		for (int i = levelBegin; i < levelEnd; ++i)
+		{
+			frontierEdges += m_OutStart[m_Queue[i] + 1] - m_OutStart[m_Queue[i]];
+		}
+
+		unexploredEdges -= frontierEdges;
+
+		if (!bottomUp && frontierEdges * k_TopDownToBottomUp > unexploredEdges)
+		{
+			bottomUp = true;
+		}
+		else if (bottomUp && (levelEnd - levelBegin) * k_BottomUpToTopDown < numNodes)
+		{
+			bottomUp = false;
+		}
+
+		if (!bottomUp)
+		{
+			for (int i = levelBegin; i < levelEnd; ++i)
+			{
+				const int node = m_Queue[i];
+
+				for (int e = m_OutStart[node]; e < m_OutStart[node + 1]; ++e)
+				{
+					const int to = m_OutTarget[e];
+
+					if (m_Visited.TestAndSet(to))
+					{
+						m_Queue[queueEnd++] = to;
+
+						if (!a_visitor(to, node, depth))
+						{
+							return queueEnd;
+						}
+					}
+				}
+			}
+		}
+		else
+		{
+			m_Frontier.ResetAll();
+
+			for (int i = levelBegin; i < levelEnd; ++i)
+			{
+				m_Frontier.Set(m_Queue[i]);
+			}
+
+			//Walk the unvisited nodes a word at a time
+			const uint64_t* visitedWords = m_Visited.Words();
+
+			for (int w = 0; w < m_Visited.NumWords(); ++w)
+			{
+				for (uint64_t unvisited = ~visitedWords[w]; unvisited; unvisited &= unvisited - 1)
+				{
+					const int node = (w << 6) + FindFirstSet64(unvisited);
+
+					if (node >= numNodes)
+					{
+						break;
+					}
+
+					for (int e = m_InStart[node]; e < m_InStart[node + 1]; ++e)
+					{
+						const int parent = m_InSource[e];
+
+						if (m_Frontier.Test(parent))
+						{
+							m_Visited.Set(node);
+							m_Queue[queueEnd++] = node;
+
+							if (!a_visitor(node, parent, depth))
+							{
+								return queueEnd;
+							}
+
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		levelBegin = levelEnd;
+		levelEnd = queueEnd;
+	}
+
+	return queueEnd;
+}
+
+template<class graph_type>
+template<class visitor_type>
+int GraphTraversal<graph_type>::DepthFirst(int a_start, visitor_type a_visitor)
+{
+	m_Visited.ResetAll();
+
+	if (a_start < 0 || a_start >= (int)m_Stack.size())
+	{
+		return 0;
+	}
+
+	//Nodes are marked when pushed, so the stack never holds more than one entry per node
+	int top = 0;
+	int numReached = 1;
+
+	m_Visited.Set(a_start);
+	m_Stack[0].node = a_start;
+	m_Stack[0].nextEdge = m_OutStart[a_start];
+
+	if (!a_visitor(a_start, invalid_node_index, 0))
+	{
+		return numReached;
+	}
+
+	while (top >= 0)
+	{
+		StackEntry& entry = m_Stack[top];
+
+		if (entry.nextEdge == m_OutStart[entry.node + 1])
+		{
+			--top; //All edges of this node done, backtrack
+			continue;
+		}
+
+		const int to = m_OutTarget[entry.nextEdge++];
+
+		if (m_Visited.TestAndSet(to))
+		{
+			++numReached;
+
+			if (!a_visitor(to, entry.node, top + 1))
+			{
+				return numReached;
+			}
+
+			++top;
+			m_Stack[top].node = to;
+			m_Stack[top].nextEdge = m_OutStart[to];
+		}
+	}
+
+	return numReached;
+}
+
+template<class graph_type>
+bool GraphTraversal<graph_type>::IsReachable(int a_from, int a_to)
+{
+	bool found = false;
+
+	BreadthFirst(a_from, [&](int a_node, int, int)
+	{
+		found = a_node == a_to;
+		return !found;
+	});
+
+	return found;
+}
+
+template<class graph_type>
+int GraphTraversal<graph_type>::HopDistance(int a_from, int a_to)
+{
+	int hops = -1;
+
+	BreadthFirst(a_from, [&](int a_node, int, int a_depth)
+	{
+		if (a_node == a_to)
+		{
+			hops = a_depth;
+			return false;
+		}
+
+		return true;
+	});
+
+	return hops;
+}
+
+template<class graph_type>
+int GraphTraversal<graph_type>::CountReachable(int a_start)
+{
+	return BreadthFirst(a_start, [](int, int, int) { return true; });
+}
+
+template<class graph_type>
+void GraphTraversal<graph_type>::HopDistances(int a_start, std::vector<int>& a_hops, int a_maxHops)
+{
+	a_hops.assign(m_Queue.size(), -1);
+
+	BreadthFirst(a_start, [&](int a_node, int, int a_depth)
+	{
+		a_hops[a_node] = a_depth;
+		return true;
+	}, a_maxHops);
+}
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <AI/Pathfinding/NodeTypeEnumerations.h>
+#include <AI/Pathfinding/ThreadPool.h>
+
+#include <DirectXMath.h>
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+//Exact all-pairs shortest paths for small graphs (a few thousand nodes), baked with a blocked Floyd-Warshall. The
+//matrix is split into 64 x 64 tiles and each round k relaxes the diagonal tile (k, k), then the tiles in row and
+//column k, then every other tile, the last two steps spread over the ThreadPool. A tile update is a min-plus product
+//done four columns at a time with DirectXMath: add, compare, and select both the distance and the first hop.
+//
+//Keeps a float distance matrix and a 16 bit next-hop matrix, so a query is one table read and a path is a walk along
+//next hops. Bake again after editing the graph.
+template <class graph_type>
+class Graph_AllPairsTable
+{
+public:
+	static const int k_MaxNodes = 0xFFFF; //Next hops are 16 bit, with 0xFFFF meaning none
+
+	//Uses ThreadPool::Get() unless given a pool
+	explicit Graph_AllPairsTable(const graph_type& graph, ThreadPool* pool = nullptr);
+
+	void Bake();
+
+	int NumNodes() const { return m_NumNodes; }
+
+	//Infinity if a_to is unreachable
+	float GetCost(int a_from, int a_to) const { return m_Distance[(size_t)a_from * m_Stride + a_to]; }
+	bool IsReachable(int a_from, int a_to) const { return m_NextHop[(size_t)a_from * m_NumNodes + a_to] != k_NoHop; }
+
+	//Node after a_from on a shortest path to a_to; invalid_node_index if a_from == a_to or a_to is unreachable
+	int GetNextNode(int a_from, int a_to) const
+	{
+		const uint16_t hop = m_NextHop[(size_t)a_from * m_NumNodes + a_to];
+
+		return (hop == k_NoHop || a_from == a_to) ? invalid_node_index : hop;
+	}
+
+	//Nodes from a_from to a_to (both included), empty if unreachable
+	void GetPath(int a_from, int a_to, std::vector<int>& a_path) const;
+private:
+	static const int k_TileShift = 6;
+	static const int k_TileSize = 1 << k_TileShift;
+	static const uint16_t k_NoHop = 0xFFFF;
+
+	void MinPlusTile(int a_tileI, int a_tileJ, int a_tileK, bool a_inPlace);
+	void RelaxRow(int a_i, int a_k, int a_firstColumn);
+
+	const graph_type& m_Graph;
+	ThreadPool& m_Pool;
+	int m_NumNodes;
+	int m_Stride; //Row length of the distance matrix, rounded up to whole tiles
+	std::vector<float> m_Distance;
+	std::vector<uint32_t> m_Via; //First hop of each distance while baking, 32 bit to share lanes with the distances
+	std::vector<uint16_t> m_NextHop; //NumNodes x NumNodes
+};
+
+template <class graph_type>
+Graph_AllPairsTable<graph_type>::Graph_AllPairsTable(const graph_type& graph, ThreadPool* pool)
+	: m_Graph(graph)
+	, m_Pool(pool ? *pool : ThreadPool::Get())
+	, m_NumNodes(0)
+	, m_Stride(0)
+{
+	Bake();
+}
+
+template <class graph_type>
+void Graph_AllPairsTable<graph_type>::Bake()
+{
+	assert(m_Graph.NumNodes() < k_MaxNodes && "<Graph_AllPairsTable::Bake>: too many nodes for 16 bit next hops");
+
+	const float infinity = std::numeric_limits<float>::infinity();
+
+	m_NumNodes = m_Graph.NumNodes();
+	m_Stride = (m_NumNodes + k_TileSize - 1) & ~(k_TileSize - 1);
+
+	m_Distance.assign((size_t)m_Stride * m_Stride, infinity);
+	m_Via.assign((size_t)m_Stride * m_Stride, k_NoHop);
+
+	for (int i = 0; i < m_NumNodes; ++i)
+	{
+		m_Distance[(size_t)i * m_Stride + i] = 0.f;
+		m_Via[(size_t)i * m_Stride + i] = i;
+
+		if (!m_Graph.isNodePresent(i))
+		{
+			continue;
+		}
+
+		typename graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, i);
+
+		for (const typename graph_type::EdgeType* pE = ConstEdgeItr.begin(); !ConstEdgeItr.end(); pE = ConstEdgeItr.next())
+		{
+			const size_t entry = (size_t)i * m_Stride + pE->To();
+
+			if ((float)pE->Cost() < m_Distance[entry])
+			{
+				m_Distance[entry] = (float)pE->Cost();
+				m_Via[entry] = pE->To();
+			}
+		}
+	}
+
+	const int numTiles = m_Stride >> k_TileShift;
+
+	for (int k = 0; k < numTiles; ++k)
+	{
+		MinPlusTile(k, k, k, true);
+
+		//Row and column k against the finished diagonal tile
+		m_Pool.ParallelFor(2 * numTiles, 1, [this, k, numTiles](int a_begin, int a_end)
+		{
+			for (int t = a_begin; t < a_end; ++t)
+			{
+				const int other = t % numTiles;
+
+				if (other == k)
+				{
+					continue;
+				}
+
+				if (t < numTiles)
+				{
+					MinPlusTile(k, other, k, true);
+				}
+				else
+				{
+					MinPlusTile(other, k, k, true);
+				}
+			}
+		});
+
+		//Every remaining tile only reads row and column k, so they are independent
+		m_Pool.ParallelFor(numTiles * numTiles, 1, [this, k, numTiles](int a_begin, int a_end)
+		{
+			for (int t = a_begin; t < a_end; ++t)
+			{
+				const int i = t / numTiles;
+				const int j = t % numTiles;
+
+				if (i != k && j != k)
+				{
+					MinPlusTile(i, j, k, false);
+				}
+			}
+		});
+	}
+
+	m_NextHop.resize((size_t)m_NumNodes * m_NumNodes);
+
+	for (int i = 0; i < m_NumNodes; ++i)
+	{
+		for (int j = 0; j < m_NumNodes; ++j)
+		{
+			m_NextHop[(size_t)i * m_NumNodes + j] = (uint16_t)m_Via[(size_t)i * m_Stride + j];
+		}
+	}
+
+	std::vector<uint32_t>().swap(m_Via);
+}
+
+//Relaxes tile (i, j) through the nodes of tile k: d(a, b) = min(d(a, b), d(a, c) + d(c, b)). When the tile being
+//written is also one of the two being read (the diagonal, row and column steps) the intermediate node has to be the
+//outer loop; otherwise rows go outermost so each one stays in cache while the k tile streams past it.
+template <class graph_type>
+void Graph_AllPairsTable<graph_type>::MinPlusTile(int a_tileI, int a_tileJ, int a_tileK, bool a_inPlace)
+{
+	const int firstRow = a_tileI << k_TileShift;
+	const int firstColumn = a_tileJ << k_TileShift;
+	const int firstK = a_tileK << k_TileShift;
+
+	if (a_inPlace)
+	{
+		for (int k = firstK; k < firstK + k_TileSize; ++k)
+		{
+			for (int i = firstRow; i < firstRow + k_TileSize; ++i)
+			{
+				RelaxRow(i, k, firstColumn);
+			}
+		}
+	}
+	else
+	{
+		for (int i = firstRow; i < firstRow + k_TileSize; ++i)
+		{
+			for (int k = firstK; k < firstK + k_TileSize; ++k)
+			{
+				RelaxRow(i, k, firstColumn);
+			}
+		}
+	}
+}
+
+template <class graph_type>
+void Graph_AllPairsTable<graph_type>::RelaxRow(int a_i, int a_k, int a_firstColumn)
+{
+	using namespace DirectX;
+
+	const float throughK = m_Distance[(size_t)a_i * m_Stride + a_k];
+
+	if (throughK == std::numeric_limits<float>::infinity())
+	{
+		return;
+	}
+
+	const XMVECTOR costToK = XMVectorReplicate(throughK);
+	const XMVECTOR hopToK = XMVectorReplicateInt(m_Via[(size_t)a_i * m_Stride + a_k]);
+
+	const float* fromK = &m_Distance[(size_t)a_k * m_Stride + a_firstColumn];
+	float* distance = &m_Distance[(size_t)a_i * m_Stride + a_firstColumn];
+	uint32_t* via = &m_Via[(size_t)a_i * m_Stride + a_firstColumn];
+
+	for (int j = 0; j < k_TileSize; j += 4)
+	{
+		const XMVECTOR current = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(distance + j));
+		const XMVECTOR candidate = XMVectorAdd(costToK, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(fromK + j)));
+		const XMVECTOR shorter = XMVectorLess(candidate, current);
+
+		XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(distance + j), XMVectorSelect(current, candidate, shorter));
+		XMStoreInt4(via + j, XMVectorSelect(XMLoadInt4(via + j), hopToK, shorter));
+	}
+}
+
+template <class graph_type>
+void Graph_AllPairsTable<graph_type>::GetPath(int a_from, int a_to, std::vector<int>& a_path) const
+{
+	a_path.clear();
+
+	if (!IsReachable(a_from, a_to))
+	{
+		return;
+	}
+
+	for (int node = a_from; node != a_to; node = m_NextHop[(size_t)node * m_NumNodes + a_to])
+	{
+		a_path.push_back(node);
+	}
+
+	a_path.push_back(a_to);
+}
@@ -1,16 +1,18 @@
 #pragma once
 
 #include <AI/Pathfinding/GraphEdge.h>
+#include <AI/Pathfinding/Graph_AllPairsTable.h>
 #include <AI/Pathfinding/NodeNavigation.h>
 #include <AI/Pathfinding/SparseGraph.h>
 #include <AI/Pathfinding/Graph_SearchDijkstra.h>
+#include <AI/Pathfinding/Graph_SearchDijkstraMultiSource.h>
 #include <AI/Pathfinding/NodeTypeEnumerations.h>
+#include <AI/Pathfinding/SearchStats.h>
 
-#include <ctime>
+#include <memory>
 #include <vector>
-#include <iostream>
 
-template <class graph_type>
+template <class graph_type, class stats_type = SearchStats_None>
 class Graph_FlowField
 {
 public:
@@ -19,20 +21,47 @@ public:
 
 	Graph_FlowField(const graph_type & graph)
 		: m_Graph(graph)
-		, m_FlowFields(graph.NumNodes(), std::vector<const Edge*>(graph.NumNodes(), nullptr))
+		, m_FlowFields(graph.NumNodes())
 	{}
 
 	void	GenerateAllFlowFields(); // Generates all flow fields for the given graph
 	int		GetNextNodeInPathToTarget(int a_target, int a_closestNode, bool a_generatePathsIfNotPresent = false);
 	void	GenerateFlowFieldForNode(int node);
+
+	//Bakes the paths between every pair of nodes in one go with Graph_AllPairsTable. The bake is O(N^3): on one core it
+	//measured slower than GenerateAllFlowFields' repeated Dijkstra on sparse graphs (about 0.2 s for 1200 nodes), and only
+	//pays off with several worker threads or dense graphs. GetNextNodeInPathToTarget reads from the table once it is baked,
+	//so any per-target fields generated so far are freed.
+	void	BakeAllPairs(ThreadPool* a_pool = nullptr);
+	const Graph_AllPairsTable<graph_type>* GetAllPairs() const { return m_AllPairs.get(); } //Null until BakeAllPairs
+
+	//Generates one field leading every node to its nearest goal in a_goals, optionally starting each goal at a cost
+	//from a_goalCosts (one per goal). Returns an id for the field to pass to the goal set queries below.
+	int		GenerateFlowFieldForGoals(const std::vector<int>& a_goals, const std::vector<float>* a_goalCosts = nullptr);
+	int		GetNextNodeTowardGoals(int a_goalSet, int a_closestNode) const; //invalid_node_index at a goal or if no goal is reachable
+	int		GetGoalForNode(int a_goalSet, int a_node) const { return m_GoalSetFlowFields[a_goalSet].goalOfNode[a_node]; } //Goal the node's field leads to
+	float	GetCostToGoal(int a_goalSet, int a_node) const { return m_GoalSetFlowFields[a_goalSet].costToGoal[a_node]; }
+	void	ClearGoalSetFlowFields() { m_GoalSetFlowFields.clear(); }
+
+	const stats_type& GetLastStats() const { return m_LastStats; } //Stats of the search behind the most recently generated field
 private:
+	struct GoalSetFlowField
+	{
+		ShortestPathTree paths;
+		std::vector<int> goalOfNode;
+		std::vector<float> costToGoal;
+	};
 
-	std::vector<ShortestPathTree>		m_FlowFields; //Indexed into by target node then closest node
+	std::vector<GoalSetFlowField>		m_GoalSetFlowFields; //Indexed by the id returned from GenerateFlowFieldForGoals
+
+	std::vector<ShortestPathTree>		m_FlowFields; //Indexed into by target node then closest node, empty until generated
+	std::unique_ptr<Graph_AllPairsTable<graph_type> >	m_AllPairs;
 	const graph_type&					m_Graph;
+	stats_type							m_LastStats;
 };
 
-template<class graph_type>
-void Graph_FlowField<graph_type>::GenerateAllFlowFields()
+template<class graph_type, class stats_type>
+void Graph_FlowField<graph_type, stats_type>::GenerateAllFlowFields()
 {
 	for (int i = 0; i < m_Graph.NumNodes(); ++i)
 	{
@@ -40,10 +69,15 @@ void Graph_FlowField<graph_type>::GenerateAllFlowFields()
 	}
 }
 
-template<class graph_type>
-int Graph_FlowField<graph_type>::GetNextNodeInPathToTarget(int a_target, int a_closestNode, bool a_generatePathsIfNotPresent)
+template<class graph_type, class stats_type>
+int Graph_FlowField<graph_type, stats_type>::GetNextNodeInPathToTarget(int a_target, int a_closestNode, bool a_generatePathsIfNotPresent)
 {
-	if (!m_FlowFields[a_target][a_closestNode])
+	if (m_AllPairs)
+	{
+		return m_AllPairs->GetNextNode(a_closestNode, a_target);
+	}
+
+	if (m_FlowFields[a_target].empty())
 	{
 		if (!a_generatePathsIfNotPresent)
 		{
@@ -55,19 +89,54 @@ int Graph_FlowField<graph_type>::GetNextNodeInPathToTarget(int a_target, int a_c
 		}
 	}
 
-	return m_FlowFields[a_target][a_closestNode]->From();
+	const Edge* edge = m_FlowFields[a_target][a_closestNode];
+
+	return (edge && a_closestNode != a_target) ? edge->From() : invalid_node_index; //As Graph_AllPairsTable::GetNextNode
 }
 
-template<class graph_type>
-void Graph_FlowField<graph_type>::GenerateFlowFieldForNode(int node)
+template<class graph_type, class stats_type>
+void Graph_FlowField<graph_type, stats_type>::BakeAllPairs(ThreadPool* a_pool)
 {
-	std::clock_t start;
-	start = std::clock();
+	m_AllPairs.reset(new Graph_AllPairsTable<graph_type>(m_Graph, a_pool));
 
-	Graph_SearchDijkstra<SparseGraph<NodeNavigation, GraphEdge>> graphSearch(m_Graph, node);
+	std::vector<ShortestPathTree>(m_Graph.NumNodes()).swap(m_FlowFields);
+}
 
-	double dur = (std::clock() - start) / (double)CLOCKS_PER_SEC;
-	std::cout << "Flow field for 1 node generated in " << dur << std::endl;
+template<class graph_type, class stats_type>
+void Graph_FlowField<graph_type, stats_type>::GenerateFlowFieldForNode(int node)
+{
+	Graph_SearchDijkstra<graph_type, stats_type> graphSearch(m_Graph, node);
 
 	m_FlowFields[node] = graphSearch.GetAllPaths();
+	m_LastStats = graphSearch.GetStats();
+}
+
+template<class graph_type, class stats_type>
+int Graph_FlowField<graph_type, stats_type>::GenerateFlowFieldForGoals(const std::vector<int>& a_goals, const std::vector<float>* a_goalCosts)
+{
+	Graph_SearchDijkstraMultiSource<graph_type, stats_type> graphSearch(m_Graph, a_goals, a_goalCosts);
+
+	GoalSetFlowField field;
+	field.paths = graphSearch.GetAllPaths();
+	field.goalOfNode.resize(m_Graph.NumNodes());
+	field.costToGoal.resize(m_Graph.NumNodes());
+
+	for (int i = 0; i < m_Graph.NumNodes(); ++i)
+	{
+		field.goalOfNode[i] = graphSearch.GetSourceForNode(i);
+		field.costToGoal[i] = graphSearch.GetCostToNode(i);
+	}
+
+	m_GoalSetFlowFields.push_back(field);
+	m_LastStats = graphSearch.GetStats();
+
+	return (int)m_GoalSetFlowFields.size() - 1;
+}
+
+template<class graph_type, class stats_type>
+int Graph_FlowField<graph_type, stats_type>::GetNextNodeTowardGoals(int a_goalSet, int a_closestNode) const
+{
+	const Edge* edge = m_GoalSetFlowFields[a_goalSet].paths[a_closestNode];
+
+	return edge ? edge->From() : invalid_node_index;
 }
@@ -0,0 +1,305 @@
+#pragma once
+
+#include "Heuristics.h"
+#include "PathOutput.h"
+#include "PriorityQueue.h"
+#include "SearchStats.h"
+
+#include <cassert>
+#include <cfloat>
+#include <climits>
+#include <vector>
+#include <list>
+
+//Anytime Repairing A* (Likhachev, Gordon & Thrun 2003). The first search is weighted A* with a large epsilon, so a
+//path comes back quickly; each later call lowers epsilon and repairs that search rather than starting over. Costs to
+//nodes are kept between calls, and only nodes whose cost dropped after they were expanded (kept aside in an
+//inconsistent list) are put back on the open list, so every refinement expands a small part of the graph.
+//
+//Calls can be given an expansion budget and picked up again later. The current path stays usable in between and
+//GetSuboptimalityBound, from the last finished iteration, says how far from optimal it can be; that is often well
+//under the epsilon it was searched with. Needs a consistent heuristic (e.g. Heuristic_Euclidean
+//on a nav graph) for the bounds to hold, and the graph must not change between calls.
+//
+//  Graph_SearchARAStar<NavGraph, Heuristic_Euclidean> search(graph, start, target, 2.5f);
+//  ...use search.GetPathToTarget(path), then when there is time...
+//  search.Improve(1.5f, 2000); //true once the 1.5 path is ready
+template <class graph_type, class heuristic, class stats_type = SearchStats_None>
+class Graph_SearchARAStar
+{
+private:
+	typedef typename graph_type::EdgeType Edge;
+
+	enum
+	{
+		unseen,
+		open,
+		inconsistent, //Cost dropped after it was expanded in this iteration
+		done
+	};
+
+	const graph_type& m_Graph;
+	std::vector<float> m_CostToNode; //FLT_MAX until reached
+	std::vector<float> m_Heuristic; //Cached per node, negative until first needed
+	std::vector<float> m_Key; //Cost to node + epsilon * heuristic, for the open list
+	std::vector<const Edge*> m_Parent;
+	std::vector<int> m_ExpandedIn; //Iteration a node was last expanded in
+	std::vector<unsigned char> m_State;
+	std::vector<int> m_Inconsistent;
+	IndexedPriorityQLow<float> m_Open;
+	int m_StartNode;
+	int m_TargetNode;
+	float m_Epsilon; //Epsilon of the current iteration
+	float m_Bound; //Bound of the current path, FLT_MAX until there is one
+	int m_Iteration;
+	bool m_IterationDone;
+	int m_NodesSearched;
+	stats_type m_Stats;
+public:
+	//Runs the first iteration at epsilon to completion
+	Graph_SearchARAStar(const graph_type& graph, int startNode, int targetNode, float epsilon = 3.f);
+
+	//Refines towards a_epsilon (clamped to [1, current epsilon]), expanding at most a_maxExpansions nodes. Returns true
+	//once the iteration at that epsilon has finished; otherwise call again to carry on from where it stopped.
+	bool Improve(float a_epsilon, int a_maxExpansions = INT_MAX);
+
+	bool IsPathFound() const { return m_CostToNode[m_TargetNode] < FLT_MAX; }
+	float GetCostToTarget() const; //Of the current path, which can be a little under the target's recorded cost
+	float GetEpsilon() const { return m_Epsilon; }
+	bool IsIterationDone() const { return m_IterationDone; }
+	//The current path costs at most this times the optimal cost; 1 once it is optimal
+	float GetSuboptimalityBound() const { return m_Bound; }
+	int GetNodesSearched() const { return m_NodesSearched; } //Across all calls
+	const stats_type& GetStats() const { return m_Stats; }
+
+	//Best path so far, start first; empty if there is none (see PathOutput.h)
+	std::list<int> GetPathToTarget() const;
+	void GetPathToTarget(std::vector<int>& a_path) const { WritePath(ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_path); }
+	int GetPathToTarget(int* a_buffer, int a_capacity) const { return WritePath(ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_buffer, a_capacity); }
+	void GetPathPositionsToTarget(std::vector<DirectX::XMFLOAT3>& a_positions) const { WritePathPositions(m_Graph, ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_positions); }
+private:
+	Graph_SearchARAStar(const Graph_SearchARAStar&);
+	Graph_SearchARAStar& operator=(const Graph_SearchARAStar&);
+
+	int ParentOf(int a_node) const { return (a_node == m_StartNode || !m_Parent[a_node]) ? invalid_node_index : m_Parent[a_node]->From(); }
+	int ReachedTarget() const { return IsPathFound() ? m_TargetNode : invalid_node_index; }
+
+	float HeuristicOf(int a_node)
+	{
+		if (m_Heuristic[a_node] < 0.f)
+		{
+			m_Heuristic[a_node] = heuristic::Calculate(m_Graph, m_TargetNode, a_node);
+		}
+
+		return m_Heuristic[a_node];
+	}
+
+	void BeginIteration(float a_epsilon);
+	bool ImprovePath(int a_maxExpansions);
+	void UpdateBound();
+};
+
+template <class graph_type, class heuristic, class stats_type>
+Graph_SearchARAStar<graph_type, heuristic, stats_type>::Graph_SearchARAStar(const graph_type& graph, int startNode, int targetNode, float epsilon)
+	: m_Graph(graph)
+	, m_CostToNode(graph.NumNodes(), FLT_MAX)
+	, m_Heuristic(graph.NumNodes(), -1.f)
+	, m_Key(graph.NumNodes(), 0.f)
+	, m_Parent(graph.NumNodes(), nullptr)
+	, m_ExpandedIn(graph.NumNodes(), 0)
+	, m_State(graph.NumNodes(), unseen)
+	, m_Open(m_Key, graph.NumNodes())
+	, m_StartNode(startNode)
+	, m_TargetNode(targetNode)
+	, m_Epsilon(epsilon < 1.f ? 1.f : epsilon)
+	, m_Bound(FLT_MAX)
+	, m_Iteration(1)
+	, m_IterationDone(false)
+	, m_NodesSearched(0)
+{
+	assert(targetNode >= 0 && "<Graph_SearchARAStar>: needs a target");
+
+	m_CostToNode[m_StartNode] = 0.f;
+	m_Key[m_StartNode] = m_Epsilon * HeuristicOf(m_StartNode);
+	m_State[m_StartNode] = open;
+	m_Open.insert(m_StartNode);
+	m_Stats.OnHeapPush(m_Open.size());
+
+	ImprovePath(INT_MAX);
+}
+
+template <class graph_type, class heuristic, class stats_type>
+bool Graph_SearchARAStar<graph_type, heuristic, stats_type>::Improve(float a_epsilon, int a_maxExpansions)
+{
+	if (a_epsilon < 1.f)
+	{
+		a_epsilon = 1.f;
+	}
+
+	//Lowering epsilon mid-iteration is fine: the open and inconsistent lists still hold every node that needs another look
+	if (a_epsilon < m_Epsilon)
+	{
+		BeginIteration(a_epsilon);
+	}
+	else if (m_IterationDone)
+	{
+		return true;
+	}
+
+	return ImprovePath(a_maxExpansions);
+}
+
+//Moves the inconsistent nodes back onto the open list, rekeys everything for the new epsilon and forgets which nodes
+//were expanded. Keys can go up as well as down, so the heap is rebuilt rather than adjusted.
+template <class graph_type, class heuristic, class stats_type>
+void Graph_SearchARAStar<graph_type, heuristic, stats_type>::BeginIteration(float a_epsilon)
+{
+	m_Epsilon = a_epsilon;
+	++m_Iteration;
+	m_IterationDone = false;
+
+	while (!m_Open.empty())
+	{
+		m_Inconsistent.push_back(m_Open.Pop());
+	}
+
+	for (size_t i = 0; i < m_Inconsistent.size(); ++i)
+	{
+		const int node = m_Inconsistent[i];
+
+		m_Key[node] = m_CostToNode[node] + m_Epsilon * HeuristicOf(node);
+		m_State[node] = open;
+		m_Open.insert(node);
+		m_Stats.OnHeapPush(m_Open.size());
+	}
+
+	m_Inconsistent.clear();
+}
+
+template <class graph_type, class heuristic, class stats_type>
+bool Graph_SearchARAStar<graph_type, heuristic, stats_type>::ImprovePath(int a_maxExpansions)
+{
+	m_Stats.BeginSearch();
+
+	int expansions = 0;
+
+	//Done once nothing on the open list could lead to a path cheaper than the target's
+	while (!m_Open.empty() && m_CostToNode[m_TargetNode] > m_Key[m_Open.peek()])
+	{
+		if (expansions == a_maxExpansions)
+		{
+			m_Stats.EndSearch();
+			return false;
+		}
+
+		const int node = m_Open.Pop();
+
+		m_State[node] = done;
+		m_ExpandedIn[node] = m_Iteration;
+		++expansions;
+		++m_NodesSearched;
+		m_Stats.OnNodeExpanded();
+
+		typename graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, node);
+
+		for (const Edge* edge = ConstEdgeItr.begin(); !ConstEdgeItr.end(); edge = ConstEdgeItr.next())
+		{
+			m_Stats.OnEdgeRelaxed();
+
+			const int to = edge->To();
+			const float cost = m_CostToNode[node] + edge->Cost();
+
+			if (cost >= m_CostToNode[to])
+			{
+				continue;
+			}
+
+			m_CostToNode[to] = cost;
+			m_Parent[to] = edge;
+
+			if (m_State[to] == open)
+			{
+				m_Key[to] = cost + m_Epsilon * HeuristicOf(to);
+				m_Open.ChangePriority(to);
+				m_Stats.OnDecreaseKey();
+			}
+			else if (m_State[to] == done && m_ExpandedIn[to] == m_Iteration)
+			{
+				//Already expanded at this epsilon; weighted A* doesn't reopen, the next iteration picks it up
+				m_State[to] = inconsistent;
+				m_Inconsistent.push_back(to);
+			}
+			else if (m_State[to] != inconsistent)
+			{
+				m_Key[to] = cost + m_Epsilon * HeuristicOf(to);
+				m_State[to] = open;
+				m_Open.insert(to);
+				m_Stats.OnHeapPush(m_Open.size());
+			}
+		}
+	}
+
+	m_IterationDone = true;
+	UpdateBound();
+
+	m_Stats.EndSearch();
+	return true;
+}
+
+//Every cheaper path runs through an open or inconsistent node, so the least unweighted key among them is a lower bound
+//on the optimal cost
+template <class graph_type, class heuristic, class stats_type>
+void Graph_SearchARAStar<graph_type, heuristic, stats_type>::UpdateBound()
+{
+	if (!IsPathFound())
+	{
+		m_Bound = FLT_MAX;
+		return;
+	}
+
+	float lowerBound = FLT_MAX;
+
+	for (int node = 0; node < (int)m_State.size(); ++node)
+	{
+		if (m_State[node] == open || m_State[node] == inconsistent)
+		{
+			const float estimate = m_CostToNode[node] + HeuristicOf(node);
+
+			if (estimate < lowerBound)
+			{
+				lowerBound = estimate;
+			}
+		}
+	}
+
+	const float cost = m_CostToNode[m_TargetNode];
+
+	m_Bound = (cost <= lowerBound) ? 1.f : (cost / lowerBound < m_Epsilon ? cost / lowerBound : m_Epsilon);
+}
+
+//Walks the path: nodes on it may have been improved since the target was reached through them
+template <class graph_type, class heuristic, class stats_type>
+float Graph_SearchARAStar<graph_type, heuristic, stats_type>::GetCostToTarget() const
+{
+	float cost = 0.f;
+
+	for (int node = ReachedTarget(); node != invalid_node_index && node != m_StartNode; node = ParentOf(node))
+	{
+		cost += m_Parent[node]->Cost();
+	}
+
+	return cost;
+}
+
+template <class graph_type, class heuristic, class stats_type>
+std::list<int> Graph_SearchARAStar<graph_type, heuristic, stats_type>::GetPathToTarget() const
+{
+	std::list<int> path;
+
+	for (int node = ReachedTarget(); node != invalid_node_index; node = ParentOf(node))
+	{
+		path.push_front(node);
+	}
+
+	return path;
+}
@@ -1,17 +1,25 @@
 #pragma once
 
 #include "GraphEdge.h"
+#include "GraphEdgeCosts.h"
 #include "Heuristics.h"
 #include "NodeNavigation.h"
+#include "PathOutput.h"
 #include "PriorityQueue.h"
 #include "SparseGraph.h"
+#include "SearchStats.h"
 
-#include <ctime>
-#include <iostream>
+#include <cassert>
 #include <vector>
 #include <list>
 
-template <class graph_type, class heuristic>
+//With epsilon > 1 this is weighted A*: nodes are ordered by cost + epsilon * heuristic, which heads for the target more
+//greedily and expands far fewer nodes, and the path found costs at most epsilon times the optimal one (for a
+//consistent heuristic). See Graph_SearchARAStar for a search that starts high and refines towards optimal.
+//
+//cost_type picks where edge costs are read from, as for Graph_SearchDijkstra. The heuristic has to stay admissible
+//for the costs searched with, so alternate costs should not go below the distances it estimates.
+template <class graph_type, class heuristic, class stats_type = SearchStats_None, class cost_type = EdgeCost_Graph>
 class Graph_SearchAStar
 {
 private:
@@ -33,30 +41,45 @@ private:
 	int m_StartNode;
 	int m_TargetNode;
 	int m_NodesSearched;
+	float m_Epsilon; //Heuristic weight, 1 for plain A*
+	stats_type m_Stats;
+	cost_type m_EdgeCosts;
 public:
-	Graph_SearchAStar(const graph_type& graph, int startNode, int target = -1) : m_Graph(graph),
+	Graph_SearchAStar(const graph_type& graph, int startNode, int target = -1, float epsilon = 1.f, const cost_type& costs = cost_type()) : m_Graph(graph),
 		m_ShortestPathTree(graph.NumNodes()),
 		m_NodeParents(graph.NumNodes()),
 		m_CostToNode(graph.NumNodes(), 0.f),
 		m_EstimatedCostToTargetFromNode(graph.NumNodes(), 0.f),
 		m_StartNode(startNode),
 		m_TargetNode(target),
-		m_NodesSearched(0)
+		m_NodesSearched(0),
+		m_Epsilon(epsilon),
+		m_EdgeCosts(costs)
 	{
+		assert(epsilon >= 1.f && "<Graph_SearchAStar>: epsilon below 1");
+
 		Search();
 	}
 
-	std::vector<const Edge*> GetAllPaths() const { return m_ShortestPathTree; } //Returns SPT for either whole graph, or until target is found
+	const std::vector<const Edge*>& GetAllPaths() const { return m_ShortestPathTree; } //Returns SPT for either whole graph, or until target is found
 	std::list<int> GetPathToTarget() const; //Returns path by working through SPT backwards from target
+	//Allocation-free versions: start first, empty if the target was not reached (see PathOutput.h)
+	void GetPathToTarget(std::vector<int>& a_path) const { WritePath(ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_path); }
+	int GetPathToTarget(int* a_buffer, int a_capacity) const { return WritePath(ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_buffer, a_capacity); }
+	void GetPathPositionsToTarget(std::vector<DirectX::XMFLOAT3>& a_positions) const { WritePathPositions(m_Graph, ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_positions); }
 	float GetCostToTarget() const; //Returns total cost to target
 	int GetNodesSearched() const { return m_NodesSearched; }
+	float GetSuboptimalityBound() const { return m_Epsilon; } //The path costs at most this times the optimal cost
+	const stats_type& GetStats() const { return m_Stats; }
 private:
 	Graph_SearchAStar() {}
+	int ParentOf(int a_node) const { return (a_node == m_StartNode || !m_ShortestPathTree[a_node]) ? invalid_node_index : m_ShortestPathTree[a_node]->From(); }
+	int ReachedTarget() const { return (m_TargetNode >= 0 && (m_TargetNode == m_StartNode || m_ShortestPathTree[m_TargetNode])) ? m_TargetNode : invalid_node_index; }
 	void Search();
 };
 
-template <class graph_type, class heuristic>
-std::list<int> Graph_SearchAStar<graph_type, heuristic>::GetPathToTarget() const
+template <class graph_type, class heuristic, class stats_type, class cost_type>
+std::list<int> Graph_SearchAStar<graph_type, heuristic, stats_type, cost_type>::GetPathToTarget() const
 {
 	std::list<int> path;
 
@@ -80,22 +103,26 @@ std::list<int> Graph_SearchAStar<graph_type, heuristic>::GetPathToTarget() const
 	return path;
 }
 
-template <class graph_type, class heuristic>
-float Graph_SearchAStar<graph_type, heuristic>::GetCostToTarget() const
+template <class graph_type, class heuristic, class stats_type, class cost_type>
+float Graph_SearchAStar<graph_type, heuristic, stats_type, cost_type>::GetCostToTarget() const
 {
 	return m_CostToNode[m_TargetNode];
 }
 
-template <class graph_type, class heuristic>
-void Graph_SearchAStar<graph_type, heuristic>::Search()
+template <class graph_type, class heuristic, class stats_type, class cost_type>
+void Graph_SearchAStar<graph_type, heuristic, stats_type, cost_type>::Search()
 {
 	IndexedPriorityQLow<float> priorityQueue(m_EstimatedCostToTargetFromNode, m_Graph.NumNodes()); //Indexed priority queue, with lowest estimated cost node first
 
+	m_Stats.BeginSearch();
+
 	priorityQueue.insert(m_StartNode); //Add start node
+	m_Stats.OnHeapPush(priorityQueue.size());
 
 	while (!priorityQueue.empty())
 	{
 		++m_NodesSearched;
+		m_Stats.OnNodeExpanded();
 
 		int nextClosestNode = priorityQueue.Pop(); //Take lowest cost node from frontier
 
@@ -103,41 +130,56 @@ void Graph_SearchAStar<graph_type, heuristic>::Search()
 
 		if (nextClosestNode == m_TargetNode) //Check for success
 		{
+			m_Stats.EndSearch();
 			return;
 		}
 
-		graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, nextClosestNode);
+		typename graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, nextClosestNode);
+		int edgeIndex = m_EdgeCosts.FirstEdge(nextClosestNode);
 
-		for (const Edge* edge = ConstEdgeItr.begin(); !ConstEdgeItr.end(); edge = ConstEdgeItr.next()) //Loop through all edges adjacent to nextClosestNode
+		for (const Edge* edge = ConstEdgeItr.begin(); !ConstEdgeItr.end(); edge = ConstEdgeItr.next(), ++edgeIndex) //Loop through all edges adjacent to nextClosestNode
 		{
+			if (m_ShortestPathTree[edge->To()] != 0 || !m_EdgeCosts.Allows(edge->To())) //Skip nodes already expanded before asking for the cost
+			{
+				continue;
+			}
+
+			m_Stats.OnEdgeRelaxed();
+
+			const float edgeCost = m_EdgeCosts.Cost(*edge, edgeIndex);
+
 			if (m_NodeParents[edge->To()] == 0) //If the node has no parent yet (i.e. it hasn't been on the frontier yet)
 			{
-				float heuristicCost = heuristic::Calculate(m_Graph, m_TargetNode, edge->To()); //Calculate heuristic cost for this edge
+				float heuristicCost = m_Epsilon * heuristic::Calculate(m_Graph, m_TargetNode, edge->To()); //Calculate (weighted) heuristic cost for this edge
 
-				float nextNodeCost = m_CostToNode[nextClosestNode] + edge->Cost(); //Note the cost to get to the node this edge leads to
+				float nextNodeCost = m_CostToNode[nextClosestNode] + edgeCost; //Note the cost to get to the node this edge leads to
 
 				m_EstimatedCostToTargetFromNode[edge->To()] = nextNodeCost + heuristicCost; //Set estimated cost to destination using this path
 
 				m_CostToNode[edge->To()] = nextNodeCost; //Set the cost to this node
 
 				priorityQueue.insert(edge->To()); //Add it to the priority queue
+				m_Stats.OnHeapPush(priorityQueue.size());
 
 				m_NodeParents[edge->To()] = edge; //Set its parent to the current edge
 			}
-			else if ((m_CostToNode[nextClosestNode] + edge->Cost() < m_CostToNode[edge->To()]) && m_ShortestPathTree[edge->To()] == 0) //If the cost using current node is < existing path
+			else if (m_CostToNode[nextClosestNode] + edgeCost < m_CostToNode[edge->To()]) //If the cost using current node is < existing path
 			{
-				float heuristicCost = heuristic::Calculate(m_Graph, m_TargetNode, edge->To()); //Calculate heuristic cost for this edge
+				float heuristicCost = m_Epsilon * heuristic::Calculate(m_Graph, m_TargetNode, edge->To()); //Calculate (weighted) heuristic cost for this edge
 
-				float nextNodeCost = m_CostToNode[nextClosestNode] + edge->Cost(); //Note the cost to get to the node this edge leads to
+				float nextNodeCost = m_CostToNode[nextClosestNode] + edgeCost; //Note the cost to get to the node this edge leads to
 
 				m_EstimatedCostToTargetFromNode[edge->To()] = nextNodeCost + heuristicCost;//Set estimated cost to destination using this path
 
 				m_CostToNode[edge->To()] = nextNodeCost; //Set new cost of node
 
 				priorityQueue.ChangePriority(edge->To()); //Change its priority in the queue to match new cost
+				m_Stats.OnDecreaseKey();
 
 				m_NodeParents[edge->To()] = edge; //Set its parent to the current edge
 			}
 		}
 	}
+
+	m_Stats.EndSearch();
 }
@@ -3,11 +3,13 @@
 #include "GraphNode.h"
 #include "GraphEdge.h"
 #include "SparseGraph.h"
+#include "PathOutput.h"
+#include "SearchStats.h"
 
 #include <list>
 #include <queue>
 
-template <class graph_type>
+template <class graph_type, class stats_type = SearchStats_None>
 class Graph_SearchBFS
 {
 public:
@@ -15,6 +17,7 @@ public:
 		m_StartNode(startNode),
 		m_TargetNode(target),
 		m_PathFound(false),
+		m_NodesSearched(0),
 		m_Visited(m_Graph.NumNodes(), unvisited),
 		m_NodeParents(m_Graph.NumNodes(), no_parent_assigned)
 	{
@@ -22,9 +25,17 @@ public:
 	}
 
 	bool IsPathFound() const { return m_PathFound; }
+	const stats_type& GetStats() const { return m_Stats; }
+	int GetNodesSearched() const { return m_NodesSearched; }
 	std::list<int> GetPathToTarget() const;
+	//Allocation-free versions: start first, empty if no path was found (see PathOutput.h)
+	void GetPathToTarget(std::vector<int>& a_path) const { WritePath(ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_path); }
+	int GetPathToTarget(int* a_buffer, int a_capacity) const { return WritePath(ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_buffer, a_capacity); }
+	void GetPathPositionsToTarget(std::vector<DirectX::XMFLOAT3>& a_positions) const { WritePathPositions(m_Graph, ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_positions); }
 private:
 	Graph_SearchBFS();
+	int ParentOf(int a_node) const { return a_node == m_StartNode ? invalid_node_index : m_NodeParents[a_node]; }
+	int ReachedTarget() const { return (m_PathFound && m_TargetNode >= 0) ? m_TargetNode : invalid_node_index; }
 	bool Search();
 
 	enum
@@ -43,10 +54,12 @@ private:
 	int m_StartNode;
 	int m_TargetNode;
 	bool m_PathFound;
+	stats_type m_Stats;
+	int m_NodesSearched;
 };
 
-template<class graph_type>
-std::list<int> Graph_SearchBFS<graph_type>::GetPathToTarget() const
+template<class graph_type, class stats_type>
+std::list<int> Graph_SearchBFS<graph_type, stats_type>::GetPathToTarget() const
 {
 	std::list<int> path;
 
@@ -69,12 +82,15 @@ std::list<int> Graph_SearchBFS<graph_type>::GetPathToTarget() const
 	return path;
 }
 
-template<class graph_type>
-bool Graph_SearchBFS<graph_type>::Search()
+template<class graph_type, class stats_type>
+bool Graph_SearchBFS<graph_type, stats_type>::Search()
 {
+	m_Stats.BeginSearch();
+
 	std::queue<const Edge*> queue;
 	const Edge firstEdgeDummy(m_StartNode, m_StartNode, 0.f); //Create first dummy edge so the queue is not empty
 	queue.push(&firstEdgeDummy);
+	m_Stats.OnHeapPush((int)queue.size());
 	
 	m_Visited[m_StartNode] = visited;
 
@@ -84,25 +100,34 @@ bool Graph_SearchBFS<graph_type>::Search()
 
 		queue.pop();
 
+		++m_NodesSearched;
+		m_Stats.OnNodeExpanded();
+
 		m_NodeParents[nextEdge->To()] = nextEdge->From(); //Mark the parent of this node
 
 		if (nextEdge->To() == m_TargetNode) //Check for success
 		{
+			m_Stats.EndSearch();
 			return true;
 		}
 
-		graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, nextEdge->To());
+		typename graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, nextEdge->To());
 
 		for (const Edge *e = ConstEdgeItr.begin(); !ConstEdgeItr.end(); e = ConstEdgeItr.next())
 		{
+			m_Stats.OnEdgeRelaxed();
+
 			if (m_Visited[e->To()] == unvisited) //If node isn't visited, add edge to queue and mark as visited
 			{
 				queue.push(e);
+				m_Stats.OnHeapPush((int)queue.size());
 
 				m_Visited[e->To()] = visited;
 			}
 		}
 	}
 
+	m_Stats.EndSearch();
+
 	return false; //No path found
 }
\ No newline at end of file
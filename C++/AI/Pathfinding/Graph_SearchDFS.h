@@ -3,11 +3,13 @@
 #include "GraphNode.h"
 #include "GraphEdge.h"
 #include "SparseGraph.h"
+#include "PathOutput.h"
+#include "SearchStats.h"
 
 #include <list>
 #include <stack>
 
-template <class graph_type>
+template <class graph_type, class stats_type = SearchStats_None>
 class Graph_SearchDFS
 {
 public:
@@ -22,9 +24,16 @@ public:
 	}
 
 	bool IsPathFound() const { return m_PathFound; }
+	const stats_type& GetStats() const { return m_Stats; }
 	std::list<int> GetPathToTarget() const;
+	//Allocation-free versions: start first, empty if no path was found (see PathOutput.h)
+	void GetPathToTarget(std::vector<int>& a_path) const { WritePath(ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_path); }
+	int GetPathToTarget(int* a_buffer, int a_capacity) const { return WritePath(ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_buffer, a_capacity); }
+	void GetPathPositionsToTarget(std::vector<DirectX::XMFLOAT3>& a_positions) const { WritePathPositions(m_Graph, ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_positions); }
 private:
 	Graph_SearchDFS();
+	int ParentOf(int a_node) const { return a_node == m_StartNode ? invalid_node_index : m_NodeParents[a_node]; }
+	int ReachedTarget() const { return (m_PathFound && m_TargetNode >= 0) ? m_TargetNode : invalid_node_index; }
 	bool Search();
 
 	enum
@@ -43,10 +52,11 @@ private:
 	int m_StartNode;
 	int m_TargetNode;
 	bool m_PathFound;
+	stats_type m_Stats;
 };
 
-template<class graph_type>
-std::list<int> Graph_SearchDFS<graph_type>::GetPathToTarget() const
+template<class graph_type, class stats_type>
+std::list<int> Graph_SearchDFS<graph_type, stats_type>::GetPathToTarget() const
 {
 	std::list<int> path;
 
@@ -69,14 +79,17 @@ std::list<int> Graph_SearchDFS<graph_type>::GetPathToTarget() const
 	return path;
 }
 
-template<class graph_type>
-bool Graph_SearchDFS<graph_type>::Search()
+template<class graph_type, class stats_type>
+bool Graph_SearchDFS<graph_type, stats_type>::Search()
 {
+	m_Stats.BeginSearch();
+
 	std::stack<const Edge*> stack;
 
 	//Create first dummy edge so the stack is not empty
 	Edge firstEdgeDummy(m_StartNode, m_StartNode, 0.f);
 	stack.push(&firstEdgeDummy);
+	m_Stats.OnHeapPush((int)stack.size());
 
 	while (!stack.empty())
 	{
@@ -84,25 +97,33 @@ bool Graph_SearchDFS<graph_type>::Search()
 
 		stack.pop(); //Remove topmost edge from the stack
 
+		m_Stats.OnNodeExpanded();
+
 		m_NodeParents[nextEdge->To()] = nextEdge->From(); //Note parent of destination node
 
 		m_Visited[nextEdge->To()] = visited; //Mark destination node as visited
 
 		if (nextEdge->To() == m_TargetNode) //Test for success
 		{
+			m_Stats.EndSearch();
 			return true;
 		}
 
-		graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, nextEdge->To());
+		typename graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, nextEdge->To());
 
 		for (const Edge* e = ConstEdgeItr.begin(); !ConstEdgeItr.end(); e = ConstEdgeItr.next()) //Loop through adjacent edges
 		{
+			m_Stats.OnEdgeRelaxed();
+
 			if (m_Visited[e->To()] == unvisited) //If unvisited, push onto the stack
 			{
 				stack.push(e);
+				m_Stats.OnHeapPush((int)stack.size());
 			}
 		}
 	}
 
+	m_Stats.EndSearch();
+
 	return false; //No path found
 }
\ No newline at end of file
@@ -0,0 +1,452 @@
+#pragma once
+
+#include <AI/Pathfinding/NodeTypeEnumerations.h>
+#include <AI/Pathfinding/PathOutput.h>
+#include <AI/Pathfinding/ThreadPool.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <list>
+#include <vector>
+
+//Parallel single-source shortest paths (Meyer & Sanders delta-stepping). Tentative costs are kept in buckets of width
+//delta; every node in the lowest bucket is expanded at once, light edges (cost <= delta) repeatedly until the bucket
+//stops refilling, then heavy edges once. Nodes are split between owners (one per pool thread): an owner expands its own
+//nodes and writes relaxation requests into per-destination outboxes, then each owner applies the requests aimed at its
+//nodes, so no cost is ever written by two threads. The result is the same shortest path tree Graph_SearchDijkstra
+//builds from the source, for graphs large enough that the per-phase synchronisation pays for itself.
+//
+//Every tentative cost lies within the longest edge of the bucket being expanded, so the buckets are a ring of
+//maxEdgeCost / delta + a few slots reused as the search moves on, however far the costs run.
+template <class graph_type>
+class Graph_SearchDeltaStepping
+{
+private:
+	typedef typename graph_type::EdgeType Edge;
+
+	struct Request
+	{
+		int to;
+		int edge; //Index into the CSR edge arrays
+		float cost;
+	};
+
+	struct Owner
+	{
+		std::vector<std::vector<int> > buckets; //Ring, bucket b in slot b % m_NumBuckets
+		std::vector<int> frontier;
+		std::vector<int> expanded; //Nodes expanded from the current bucket, whose heavy edges are relaxed once it empties
+		std::vector<std::vector<Request> > outbox; //One per destination owner
+		int firstBucket; //Lowest bucket that may be non-empty
+		int nodesSearched;
+	};
+
+	static const int k_OwnerBlockShift = 6; //Nodes are dealt to owners in blocks of 64 so a wavefront spreads over all of them
+
+	const graph_type& m_Graph;
+	ThreadPool& m_Pool;
+	int m_SourceNode;
+	float m_Delta;
+	float m_InvDelta;
+	int m_NumBuckets; //Ring size
+
+	//CSR snapshot of the graph, light edges first in every node's range
+	std::vector<int> m_EdgeStart;
+	std::vector<int> m_LightEnd;
+	std::vector<int> m_EdgeTo;
+	std::vector<float> m_EdgeCost;
+	std::vector<const Edge*> m_EdgePtr;
+
+	std::vector<float> m_CostToNode; //FLT_MAX for nodes not reached
+	std::vector<float> m_ExpandedCost; //Cost a node was last expanded with, to skip duplicate bucket entries
+	std::vector<int> m_ParentEdge; //CSR index of the edge the best path arrives by
+	std::vector<const Edge*> m_ShortestPathTree;
+	std::vector<int> m_ExpandedInBucket;
+	std::vector<Owner> m_Owners;
+public:
+	//a_delta <= 0 picks the mean edge cost. Uses ThreadPool::Get() unless given a pool.
+	Graph_SearchDeltaStepping(const graph_type& graph, int source, float delta = 0.f, ThreadPool* pool = nullptr);
+
+	const std::vector<const Edge*>& GetAllPaths() const { return m_ShortestPathTree; } //Returns the SPT from the source to every reached node
+	std::list<int> GetPathToNode(int a_node) const; //Returns path from the source to a_node, empty if unreachable
+	//Allocation-free versions: source first, empty if a_node was not reached (see PathOutput.h)
+	void GetPathToNode(int a_node, std::vector<int>& a_path) const { WritePath(ReachedNode(a_node), [this](int a_n) { return ParentOf(a_n); }, a_path); }
+	int GetPathToNode(int a_node, int* a_buffer, int a_capacity) const { return WritePath(ReachedNode(a_node), [this](int a_n) { return ParentOf(a_n); }, a_buffer, a_capacity); }
+	void GetPathPositionsToNode(int a_node, std::vector<DirectX::XMFLOAT3>& a_positions) const { WritePathPositions(m_Graph, ReachedNode(a_node), [this](int a_n) { return ParentOf(a_n); }, a_positions); }
+	float GetCostToNode(int a_node) const { return m_CostToNode[a_node]; }
+	bool IsReachable(int a_node) const { return m_CostToNode[a_node] != FLT_MAX; }
+	float GetDelta() const { return m_Delta; }
+	int GetNodesSearched() const;
+private:
+	int OwnerOf(int a_node) const { return (a_node >> k_OwnerBlockShift) % (int)m_Owners.size(); }
+	int BucketOf(float a_cost) const { return (int)(a_cost * m_InvDelta); }
+	int SlotOf(int a_bucket) const { return a_bucket % m_NumBuckets; }
+	int ParentOf(int a_node) const { return m_ParentEdge[a_node] != invalid_node_index ? m_EdgePtr[m_ParentEdge[a_node]]->From() : invalid_node_index; }
+	int ReachedNode(int a_node) const { return (a_node >= 0 && IsReachable(a_node)) ? a_node : invalid_node_index; }
+
+	void BuildAdjacency(float a_delta);
+	void Search();
+	void ExpandBucket(Owner& a_owner, int a_bucket);
+	void ExpandHeavy(Owner& a_owner);
+	void ApplyRequests(int a_owner, int a_bucket);
+	void PushRequest(Owner& a_owner, int a_from, int a_edge);
+	void RunOwners(void (Graph_SearchDeltaStepping::*a_phase)(int, int), int a_bucket);
+	void ExpandBucketPhase(int a_owner, int a_bucket) { ExpandBucket(m_Owners[a_owner], a_bucket); }
+	void ExpandHeavyPhase(int a_owner, int) { ExpandHeavy(m_Owners[a_owner]); }
+};
+
+template<class graph_type>
+Graph_SearchDeltaStepping<graph_type>::Graph_SearchDeltaStepping(const graph_type& graph, int source, float delta, ThreadPool* pool)
+	: m_Graph(graph)
+	, m_Pool(pool ? *pool : ThreadPool::Get())
+	, m_SourceNode(source)
+	, m_Delta(delta)
+	, m_InvDelta(0.f)
+	, m_NumBuckets(1)
+	, m_CostToNode(graph.NumNodes(), FLT_MAX)
+	, m_ExpandedCost(graph.NumNodes(), -1.f)
+	, m_ParentEdge(graph.NumNodes(), invalid_node_index)
+	, m_ShortestPathTree(graph.NumNodes(), nullptr)
+	, m_ExpandedInBucket(graph.NumNodes(), -1)
+	, m_Owners(m_Pool.NumThreads())
+{
+	BuildAdjacency(delta);
+
+	for (size_t o = 0; o < m_Owners.size(); ++o)
+	{
+		m_Owners[o].buckets.resize(m_NumBuckets);
+		m_Owners[o].outbox.resize(m_Owners.size());
+		m_Owners[o].firstBucket = 0;
+		m_Owners[o].nodesSearched = 0;
+	}
+	Search();
+}
+
+template<class graph_type>
+void Graph_SearchDeltaStepping<graph_type>::BuildAdjacency(float a_delta)
+{
+	const int numNodes = m_Graph.NumNodes();
+	const int chunkSize = 4096;
+	const int numChunks = (numNodes + chunkSize - 1) / chunkSize;
+
+	std::vector<double> chunkCost(numChunks, 0.0);
+	std::vector<float> chunkMaxCost(numChunks, 0.f);
+
+	m_EdgeStart.assign(numNodes + 1, 0);
+	m_LightEnd.resize(numNodes);
+
+	//Degrees (stored one slot up, ready for the prefix sum) and edge cost totals for the default delta
+	m_Pool.ParallelFor(numNodes, chunkSize, [&](int a_begin, int a_end)
+	{
+		double costSum = 0.0;
+		float maxCost = 0.f;
+
+		for (int n = a_begin; n < a_end; ++n)
+		{
+			int degree = 0;
+
+			typename graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, n);
+
+			for (const Edge* edge = ConstEdgeItr.begin(); !ConstEdgeItr.end(); edge = ConstEdgeItr.next())
+			{
+				++degree;
+				costSum += edge->Cost();
+				maxCost = std::max(maxCost, (float)edge->Cost());
+			}
+
+			m_EdgeStart[n + 1] = degree;
+		}
+
+		chunkCost[a_begin / chunkSize] = costSum;
+		chunkMaxCost[a_begin / chunkSize] = maxCost;
+	});
+
+	double totalCost = 0.0;
+	float maxEdgeCost = 0.f;
+
+	for (int c = 0; c < numChunks; ++c)
+	{
+		totalCost += chunkCost[c];
+		maxEdgeCost = std::max(maxEdgeCost, chunkMaxCost[c]);
+	}
+
+	for (int n = 0; n < numNodes; ++n)
+	{
+		m_EdgeStart[n + 1] += m_EdgeStart[n];
+	}
+
+	const int numEdges = m_EdgeStart[numNodes];
+
+	if (a_delta <= 0.f)
+	{
+		a_delta = numEdges > 0 ? (float)(totalCost / numEdges) : 1.f;
+
+		if (a_delta <= 0.f)
+		{
+			a_delta = 1.f;
+		}
+	}
+
+	m_Delta = a_delta;
+	m_InvDelta = 1.f / a_delta;
+
+	//A node expanded from bucket b costs under (b + 1) * delta, so nothing it reaches lands past b + 1 + maxEdgeCost /
+	//delta. One more slot covers rounding in BucketOf and one the heavy phase, whose requests are applied for b + 1.
+	m_NumBuckets = (int)(maxEdgeCost * m_InvDelta) + 4;
+
+	m_EdgeTo.resize(numEdges);
+	m_EdgeCost.resize(numEdges);
+	m_EdgePtr.resize(numEdges);
+
+	//Fill each node's range with light edges from the front and heavy edges from the back
+	m_Pool.ParallelFor(numNodes, chunkSize, [&](int a_begin, int a_end)
+	{
+		for (int n = a_begin; n < a_end; ++n)
+		{
+			int light = m_EdgeStart[n];
+			int heavy = m_EdgeStart[n + 1];
+
+			typename graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, n);
+
+			for (const Edge* edge = ConstEdgeItr.begin(); !ConstEdgeItr.end(); edge = ConstEdgeItr.next())
+			{
+				int slot = edge->Cost() <= m_Delta ? light++ : --heavy;
+
+				m_EdgeTo[slot] = edge->To();
+				m_EdgeCost[slot] = (float)edge->Cost();
+				m_EdgePtr[slot] = edge;
+			}
+
+			m_LightEnd[n] = light;
+		}
+	});
+}
+
+template<class graph_type>
+void Graph_SearchDeltaStepping<graph_type>::PushRequest(Owner& a_owner, int a_from, int a_edge)
+{
+	Request request;
+	request.to = m_EdgeTo[a_edge];
+	request.edge = a_edge;
+	request.cost = m_CostToNode[a_from] + m_EdgeCost[a_edge];
+
+	//Only worth sending if it beats what the node had when this phase started
+	if (request.cost < m_CostToNode[request.to])
+	{
+		a_owner.outbox[OwnerOf(request.to)].push_back(request);
+	}
+}
+
+template<class graph_type>
+void Graph_SearchDeltaStepping<graph_type>::ExpandBucket(Owner& a_owner, int a_bucket)
+{
+	a_owner.frontier.clear();
+
+	a_owner.frontier.swap(a_owner.buckets[SlotOf(a_bucket)]);
+
+	for (size_t i = 0; i < a_owner.frontier.size(); ++i)
+	{
+		int node = a_owner.frontier[i];
+		float cost = m_CostToNode[node];
+
+		//A node improved twice within the bucket is listed twice; expand it once per cost
+		if (m_ExpandedCost[node] == cost)
+		{
+			continue;
+		}
+
+		m_ExpandedCost[node] = cost;
+		++a_owner.nodesSearched;
+
+		if (m_ExpandedInBucket[node] != a_bucket)
+		{
+			m_ExpandedInBucket[node] = a_bucket;
+			a_owner.expanded.push_back(node);
+		}
+
+		for (int e = m_EdgeStart[node]; e < m_LightEnd[node]; ++e)
+		{
+			PushRequest(a_owner, node, e);
+		}
+	}
+}
+
+template<class graph_type>
+void Graph_SearchDeltaStepping<graph_type>::ExpandHeavy(Owner& a_owner)
+{
+	//Costs of these nodes are final now the bucket is empty, so their heavy edges only need relaxing once
+	for (size_t i = 0; i < a_owner.expanded.size(); ++i)
+	{
+		int node = a_owner.expanded[i];
+
+		for (int e = m_LightEnd[node]; e < m_EdgeStart[node + 1]; ++e)
+		{
+			PushRequest(a_owner, node, e);
+		}
+	}
+
+	a_owner.expanded.clear();
+}
+
+template<class graph_type>
+void Graph_SearchDeltaStepping<graph_type>::ApplyRequests(int a_owner, int a_bucket)
+{
+	Owner& owner = m_Owners[a_owner];
+
+	for (size_t s = 0; s < m_Owners.size(); ++s)
+	{
+		std::vector<Request>& inbox = m_Owners[s].outbox[a_owner];
+
+		for (size_t r = 0; r < inbox.size(); ++r)
+		{
+			const Request& request = inbox[r];
+
+			if (request.cost < m_CostToNode[request.to])
+			{
+				m_CostToNode[request.to] = request.cost;
+				m_ParentEdge[request.to] = request.edge;
+
+				//Costs never drop below the bucket being expanded
+				int bucket = std::max(BucketOf(request.cost), a_bucket);
+
+				assert(bucket - a_bucket < m_NumBuckets - 1 && "<Graph_SearchDeltaStepping>: bucket past the end of the ring");
+
+				owner.buckets[SlotOf(bucket)].push_back(request.to);
+				owner.firstBucket = std::min(owner.firstBucket, bucket);
+			}
+		}
+
+		inbox.clear();
+	}
+}
+
+template<class graph_type>
+void Graph_SearchDeltaStepping<graph_type>::RunOwners(void (Graph_SearchDeltaStepping::*a_phase)(int, int), int a_bucket)
+{
+	m_Pool.ParallelFor((int)m_Owners.size(), 1, [&](int a_begin, int a_end)
+	{
+		for (int o = a_begin; o < a_end; ++o)
+		{
+			(this->*a_phase)(o, a_bucket);
+		}
+	});
+}
+
+template<class graph_type>
+void Graph_SearchDeltaStepping<graph_type>::Search()
+{
+	if (m_SourceNode < 0 || m_SourceNode >= m_Graph.NumNodes())
+	{
+		return;
+	}
+
+	Owner& sourceOwner = m_Owners[OwnerOf(m_SourceNode)];
+
+	m_CostToNode[m_SourceNode] = 0.f;
+	sourceOwner.buckets[0].push_back(m_SourceNode);
+
+	int nextBucket = 0; //Every bucket below this has been expanded
+
+	for (;;)
+	{
+		//Lowest non-empty bucket over all owners. The ring only holds buckets nextBucket .. nextBucket + m_NumBuckets - 1,
+		//so each owner's scan starts no lower than nextBucket and stops after one lap.
+		int bucket = -1;
+
+		for (size_t o = 0; o < m_Owners.size(); ++o)
+		{
+			Owner& owner = m_Owners[o];
+			owner.firstBucket = std::max(owner.firstBucket, nextBucket);
+
+			const int lapEnd = nextBucket + m_NumBuckets;
+
+			while (owner.firstBucket < lapEnd && owner.buckets[SlotOf(owner.firstBucket)].empty())
+			{
+				++owner.firstBucket;
+			}
+
+			if (owner.firstBucket < lapEnd && (bucket == -1 || owner.firstBucket < bucket))
+			{
+				bucket = owner.firstBucket;
+			}
+		}
+
+		if (bucket == -1)
+		{
+			break;
+		}
+
+		//Light edges can put nodes back into this bucket, so keep going until it stays empty
+		bool bucketRefilled = true;
+
+		while (bucketRefilled)
+		{
+			RunOwners(&Graph_SearchDeltaStepping::ExpandBucketPhase, bucket);
+			RunOwners(&Graph_SearchDeltaStepping::ApplyRequests, bucket);
+
+			bucketRefilled = false;
+
+			for (size_t o = 0; o < m_Owners.size(); ++o)
+			{
+				if (!m_Owners[o].buckets[SlotOf(bucket)].empty())
+				{
+					bucketRefilled = true;
+				}
+			}
+		}
+
+		RunOwners(&Graph_SearchDeltaStepping::ExpandHeavyPhase, bucket);
+		RunOwners(&Graph_SearchDeltaStepping::ApplyRequests, bucket + 1);
+
+		nextBucket = bucket + 1;
+	}
+
+	//Resolve CSR parent indices to the graph's own edges
+	m_Pool.ParallelFor((int)m_ParentEdge.size(), 4096, [&](int a_begin, int a_end)
+	{
+		for (int n = a_begin; n < a_end; ++n)
+		{
+			if (m_ParentEdge[n] != invalid_node_index)
+			{
+				m_ShortestPathTree[n] = m_EdgePtr[m_ParentEdge[n]];
+			}
+		}
+	});
+}
+
+template<class graph_type>
+std::list<int> Graph_SearchDeltaStepping<graph_type>::GetPathToNode(int a_node) const
+{
+	std::list<int> path;
+
+	//just return an empty path if the node was not reached
+	if (a_node < 0 || !IsReachable(a_node))
+	{
+		return path;
+	}
+
+	path.push_front(a_node);
+
+	while (m_ParentEdge[a_node] != invalid_node_index)
+	{
+		a_node = m_EdgePtr[m_ParentEdge[a_node]]->From();
+
+		path.push_front(a_node);
+	}
+
+	return path;
+}
+
+template<class graph_type>
+int Graph_SearchDeltaStepping<graph_type>::GetNodesSearched() const
+{
+	int nodesSearched = 0;
+
+	for (size_t o = 0; o < m_Owners.size(); ++o)
+	{
+		nodesSearched += m_Owners[o].nodesSearched;
+	}
+
+	return nodesSearched;
+}
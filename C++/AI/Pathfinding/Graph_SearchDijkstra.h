@@ -7,15 +7,18 @@
 
 #include <AI/Pathfinding/GraphNode.h>
 #include <AI/Pathfinding/GraphEdge.h>
+#include <AI/Pathfinding/GraphEdgeCosts.h>
+#include <AI/Pathfinding/PathOutput.h>
 #include <AI/Pathfinding/SparseGraph.h>
 #include <AI/Pathfinding/PriorityQueue.h>
+#include <AI/Pathfinding/SearchStats.h>
 
-#include <ctime>
-#include <iostream>
 #include <vector>
 #include <list>
 
-template <class graph_type>
+//cost_type picks where edge costs are read from: the edges themselves, or an EdgeCost_Array over a GraphEdgeCosts
+//(e.g. one set per faction over the same graph). It can also rule edges out, as EdgeCost_Clearance does by agent size.
+template <class graph_type, class stats_type = SearchStats_None, class cost_type = EdgeCost_Graph>
 class Graph_SearchDijkstra
 {
 private:
@@ -36,8 +39,10 @@ private:
 	int m_StartNode;
 	int m_TargetNode;
 	int m_NodesSearched;
+	stats_type m_Stats;
+	cost_type m_EdgeCosts;
 public:
-	Graph_SearchDijkstra(const graph_type& graph, int startNode, int target = -1)
+	Graph_SearchDijkstra(const graph_type& graph, int startNode, int target = -1, const cost_type& costs = cost_type())
 		: m_Graph(graph)
 		, m_ShortestPathTree(graph.NumNodes())
 		, m_NodeParents(graph.NumNodes())
@@ -45,22 +50,30 @@ public:
 		, m_StartNode(startNode)
 		, m_TargetNode(target)
 		, m_NodesSearched(0)
+		, m_EdgeCosts(costs)
 	{
 		Search();
 	}
 
-	std::vector<const Edge*> GetAllPaths() const { return m_ShortestPathTree; } //Returns SPT for either whole graph, or until target is found
+	const std::vector<const Edge*>& GetAllPaths() const { return m_ShortestPathTree; } //Returns SPT for either whole graph, or until target is found
 	std::list<int> GetPathToTarget() const; //Returns path by working through SPT backwards from target
+	//Allocation-free versions: start first, empty if the target was not reached (see PathOutput.h)
+	void GetPathToTarget(std::vector<int>& a_path) const { WritePath(ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_path); }
+	int GetPathToTarget(int* a_buffer, int a_capacity) const { return WritePath(ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_buffer, a_capacity); }
+	void GetPathPositionsToTarget(std::vector<DirectX::XMFLOAT3>& a_positions) const { WritePathPositions(m_Graph, ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_positions); }
 	float GetCostToTarget() const; //Returns total cost to target
 	float GetCostToNode(int a_node) const;
 	int GetNodesSearched() const { return m_NodesSearched; }
+	const stats_type& GetStats() const { return m_Stats; }
 private:
 	Graph_SearchDijkstra() {}
+	int ParentOf(int a_node) const { return (a_node == m_StartNode || !m_ShortestPathTree[a_node]) ? invalid_node_index : m_ShortestPathTree[a_node]->From(); }
+	int ReachedTarget() const { return (m_TargetNode >= 0 && (m_TargetNode == m_StartNode || m_ShortestPathTree[m_TargetNode])) ? m_TargetNode : invalid_node_index; }
 	void Search();
 };
 
-template<class graph_type>
-std::list<int> Graph_SearchDijkstra<graph_type>::GetPathToTarget() const
+template<class graph_type, class stats_type, class cost_type>
+std::list<int> Graph_SearchDijkstra<graph_type, stats_type, cost_type>::GetPathToTarget() const
 {
 	std::list<int> path;
 
@@ -84,64 +97,76 @@ std::list<int> Graph_SearchDijkstra<graph_type>::GetPathToTarget() const
 	return path;
 }
 
-template<class graph_type>
-float Graph_SearchDijkstra<graph_type>::GetCostToTarget() const
+template<class graph_type, class stats_type, class cost_type>
+float Graph_SearchDijkstra<graph_type, stats_type, cost_type>::GetCostToTarget() const
 {
 	return m_CostToNode[m_TargetNode];
 }
 
-template<class graph_type>
-float Graph_SearchDijkstra<graph_type>::GetCostToNode(int a_node) const
+template<class graph_type, class stats_type, class cost_type>
+float Graph_SearchDijkstra<graph_type, stats_type, cost_type>::GetCostToNode(int a_node) const
 {
 	return m_CostToNode[a_node];
 }
 
-template<class graph_type>
-void Graph_SearchDijkstra<graph_type>::Search()
+template<class graph_type, class stats_type, class cost_type>
+void Graph_SearchDijkstra<graph_type, stats_type, cost_type>::Search()
 {
-	std::clock_t start;
-	start = std::clock();
+	m_Stats.BeginSearch();
 
 	IndexedPriorityQLow<float> priorityQueue(m_CostToNode, m_Graph.NumNodes());
 
 	priorityQueue.insert(m_StartNode); //Add start node
+	m_Stats.OnHeapPush(priorityQueue.size());
 
 	while (!priorityQueue.empty())
 	{
 		++m_NodesSearched;
+		m_Stats.OnNodeExpanded();
 		int nextClosestNode = priorityQueue.Pop(); //Take lowest cost node from frontier
 
 		m_ShortestPathTree[nextClosestNode] = m_NodeParents[nextClosestNode]; //Move edge from parents to shortest path tree
 
 		if (nextClosestNode == m_TargetNode) //Check for success
 		{
-			double dur = (std::clock() - start) / (double)CLOCKS_PER_SEC;
-			std::cout << "Dijkstra searched in " << dur << std::endl;
+			m_Stats.EndSearch();
 			return;
 		}
 
-		graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, nextClosestNode);
+		typename graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, nextClosestNode);
+		int edgeIndex = m_EdgeCosts.FirstEdge(nextClosestNode);
 
-		for (const Edge* edge = ConstEdgeItr.begin(); !ConstEdgeItr.end(); edge = ConstEdgeItr.next()) //Loop through all edges adjacent to nextClosestNode
+		for (const Edge* edge = ConstEdgeItr.begin(); !ConstEdgeItr.end(); edge = ConstEdgeItr.next(), ++edgeIndex) //Loop through all edges adjacent to nextClosestNode
 		{
-			float nextNodeCost = m_CostToNode[nextClosestNode] + edge->Cost(); //Note the cost to get to the node this edge leads to
+			if (m_ShortestPathTree[edge->To()] != 0 || !m_EdgeCosts.Allows(edge->To())) //Skip nodes already expanded before asking for the cost
+			{
+				continue;
+			}
+
+			m_Stats.OnEdgeRelaxed();
+
+			float nextNodeCost = m_CostToNode[nextClosestNode] + m_EdgeCosts.Cost(*edge, edgeIndex); //Note the cost to get to the node this edge leads to
 
 			if (m_NodeParents[edge->To()] == 0) //If the node has no parent yet (i.e. it hasn't been on the frontier yet)
 			{
 				m_CostToNode[edge->To()] = nextNodeCost; //Set the cost to this node
 
 				priorityQueue.insert(edge->To()); //Add it to the priority queue
+				m_Stats.OnHeapPush(priorityQueue.size());
 
 				m_NodeParents[edge->To()] = edge; //Set its parent to the current edge
 			}
-			else if ((nextNodeCost < m_CostToNode[edge->To()]) && m_ShortestPathTree[edge->To()] == 0) //If the cost using current node is < existing path
+			else if (nextNodeCost < m_CostToNode[edge->To()]) //If the cost using current node is < existing path
 			{
 				m_CostToNode[edge->To()] = nextNodeCost; //Set new cost of node
 
 				priorityQueue.ChangePriority(edge->To()); //Change its priority in the queue to match new cost
+				m_Stats.OnDecreaseKey();
 
 				m_NodeParents[edge->To()] = edge; //Set its parent to the current edge
 			}
 		}
 	}
+
+	m_Stats.EndSearch();
 }
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <AI/Pathfinding/Bitset.h>
+#include <AI/Pathfinding/NodeTypeEnumerations.h>
+#include <AI/Pathfinding/PathOutput.h>
+#include <AI/Pathfinding/PriorityQueue.h>
+#include <AI/Pathfinding/SearchStats.h>
+
+#include <cassert>
+#include <list>
+#include <vector>
+
+//Dijkstra seeded with a whole set of source nodes at once, each with an optional initial cost. Every node ends up
+//with the cost to its nearest source (initial cost included) and the source it resolves to, so one search answers
+//"nearest exit/resource/enemy" for the whole graph instead of running one search per source.
+template <class graph_type, class stats_type = SearchStats_None>
+class Graph_SearchDijkstraMultiSource
+{
+private:
+	typedef typename graph_type::EdgeType Edge;
+	typedef typename graph_type::NodeType Node;
+
+	const graph_type& m_Graph; //Reference to graph to be searched
+	std::vector<const Edge*> m_ShortestPathTree; //Edges that comprise best paths from every node on SPT to its nearest source
+	std::vector<float> m_CostToNode; //Total cost to node from its nearest source (accessed via node index)
+	std::vector<const Edge*> m_NodeParents; //Vector of parent edges leading to nodes in SPT, that aren't in the SPT yet (accessed by node index)
+	std::vector<int> m_SourceOfNode; //Source each node resolves to, invalid_node_index until reached
+	Bitset m_Settled; //Nodes already moved onto the SPT
+	int m_TargetNode;
+	int m_NodesSearched;
+	stats_type m_Stats;
+public:
+	//a_initialCosts, if given, holds one cost per entry of a_sources
+	Graph_SearchDijkstraMultiSource(const graph_type& graph, const std::vector<int>& sources, const std::vector<float>* initialCosts = nullptr, int target = -1)
+		: m_Graph(graph)
+		, m_ShortestPathTree(graph.NumNodes())
+		, m_CostToNode(graph.NumNodes(), 0.f)
+		, m_NodeParents(graph.NumNodes())
+		, m_SourceOfNode(graph.NumNodes(), invalid_node_index)
+		, m_Settled(graph.NumNodes())
+		, m_TargetNode(target)
+		, m_NodesSearched(0)
+	{
+		Search(sources, initialCosts);
+	}
+
+	const std::vector<const Edge*>& GetAllPaths() const { return m_ShortestPathTree; } //Returns SPT toward the nearest source for every node reached
+	std::list<int> GetPathToTarget() const; //Returns path from the target's nearest source to the target
+	//Allocation-free versions: source first, empty if the target was not reached (see PathOutput.h)
+	void GetPathToTarget(std::vector<int>& a_path) const { WritePath(ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_path); }
+	int GetPathToTarget(int* a_buffer, int a_capacity) const { return WritePath(ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_buffer, a_capacity); }
+	void GetPathPositionsToTarget(std::vector<DirectX::XMFLOAT3>& a_positions) const { WritePathPositions(m_Graph, ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_positions); }
+	float GetCostToTarget() const { return m_CostToNode[m_TargetNode]; }
+	float GetCostToNode(int a_node) const { return m_CostToNode[a_node]; }
+	int GetSourceForNode(int a_node) const { return m_SourceOfNode[a_node]; } //Nearest source, or invalid_node_index if unreachable
+	int GetNodesSearched() const { return m_NodesSearched; }
+	const stats_type& GetStats() const { return m_Stats; }
+private:
+	void Search(const std::vector<int>& a_sources, const std::vector<float>* a_initialCosts);
+	int ParentOf(int a_node) const { return m_ShortestPathTree[a_node] ? m_ShortestPathTree[a_node]->From() : invalid_node_index; }
+	int ReachedTarget() const { return (m_TargetNode >= 0 && m_SourceOfNode[m_TargetNode] != invalid_node_index) ? m_TargetNode : invalid_node_index; }
+};
+
+template<class graph_type, class stats_type>
+std::list<int> Graph_SearchDijkstraMultiSource<graph_type, stats_type>::GetPathToTarget() const
+{
+	std::list<int> path;
+
+	//just return an empty path if no target or no path found
+	if (m_TargetNode < 0 || m_SourceOfNode[m_TargetNode] == invalid_node_index)
+	{
+		return path;
+	}
+
+	int node = m_TargetNode;
+
+	path.push_front(node);
+
+	while (m_ShortestPathTree[node] != 0)
+	{
+		node = m_ShortestPathTree[node]->From();
+
+		path.push_front(node);
+	}
+
+	return path;
+}
+
+template<class graph_type, class stats_type>
+void Graph_SearchDijkstraMultiSource<graph_type, stats_type>::Search(const std::vector<int>& a_sources, const std::vector<float>* a_initialCosts)
+{
+	assert((!a_initialCosts || a_initialCosts->size() == a_sources.size()) &&
+		"<Graph_SearchDijkstraMultiSource::Search>: need one initial cost per source");
+
+	m_Stats.BeginSearch();
+
+	IndexedPriorityQLow<float> priorityQueue(m_CostToNode, m_Graph.NumNodes());
+
+	//Seed the queue with every source. A node listed twice keeps its cheapest initial cost.
+	for (size_t i = 0; i < a_sources.size(); ++i)
+	{
+		int source = a_sources[i];
+		float initialCost = a_initialCosts ? (*a_initialCosts)[i] : 0.f;
+
+		if (m_SourceOfNode[source] == invalid_node_index)
+		{
+			m_CostToNode[source] = initialCost;
+			m_SourceOfNode[source] = source;
+			priorityQueue.insert(source);
+			m_Stats.OnHeapPush(priorityQueue.size());
+		}
+		else if (initialCost < m_CostToNode[source])
+		{
+			m_CostToNode[source] = initialCost;
+			priorityQueue.ChangePriority(source);
+			m_Stats.OnDecreaseKey();
+		}
+	}
+
+	while (!priorityQueue.empty())
+	{
+		++m_NodesSearched;
+		m_Stats.OnNodeExpanded();
+
+		int nextClosestNode = priorityQueue.Pop(); //Take lowest cost node from frontier
+
+		m_Settled.Set(nextClosestNode);
+		m_ShortestPathTree[nextClosestNode] = m_NodeParents[nextClosestNode]; //Move edge from parents to shortest path tree (null for sources)
+
+		if (nextClosestNode == m_TargetNode) //Check for success
+		{
+			break;
+		}
+
+		typename graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, nextClosestNode);
+
+		for (const Edge* edge = ConstEdgeItr.begin(); !ConstEdgeItr.end(); edge = ConstEdgeItr.next()) //Loop through all edges adjacent to nextClosestNode
+		{
+			m_Stats.OnEdgeRelaxed();
+
+			int to = edge->To();
+
+			if (m_Settled.Test(to))
+			{
+				continue;
+			}
+
+			float nextNodeCost = m_CostToNode[nextClosestNode] + edge->Cost(); //Note the cost to get to the node this edge leads to
+
+			if (m_SourceOfNode[to] == invalid_node_index) //First time this node has been reached
+			{
+				m_CostToNode[to] = nextNodeCost;
+				m_SourceOfNode[to] = m_SourceOfNode[nextClosestNode];
+				m_NodeParents[to] = edge;
+
+				priorityQueue.insert(to);
+				m_Stats.OnHeapPush(priorityQueue.size());
+			}
+			else if (nextNodeCost < m_CostToNode[to]) //Cheaper through this node, possibly from a different source
+			{
+				m_CostToNode[to] = nextNodeCost;
+				m_SourceOfNode[to] = m_SourceOfNode[nextClosestNode];
+				m_NodeParents[to] = edge;
+
+				priorityQueue.ChangePriority(to);
+				m_Stats.OnDecreaseKey();
+			}
+		}
+	}
+
+	m_Stats.EndSearch();
+}
@@ -0,0 +1,226 @@
+#pragma once
+
+#include "Heuristics.h"
+#include "PathOutput.h"
+#include "SearchStats.h"
+
+#include <cassert>
+#include <cfloat>
+#include <vector>
+#include <list>
+
+//Fringe search (Bjornsson, Enzenberger, Holte & Schaeffer 2005): A* without a priority queue. The frontier is one
+//doubly linked list walked front to back in passes. A node whose cost + heuristic is within the pass's threshold is
+//expanded on the spot and its children are linked in right after it, so they are visited later in the same pass
+//("now"); nodes over the threshold are stepped past and wait for the next pass ("later"), which raises the threshold to
+//the smallest value they were over it by. Nothing is ever sorted, so each visit costs a few pointer updates rather than
+//a heap operation; the price is revisiting waiting nodes once per pass and sometimes expanding a node twice.
+//
+//Same interface as Graph_SearchAStar and, with an admissible heuristic, the same path cost. Works best where the
+//heuristic is good and the frontier narrow, as on open grid maps, and where cost + heuristic takes few distinct values
+//so each pass expands many nodes: use Heuristic_Octile on octile grids. With Heuristic_Euclidean on a grid nearly
+//every node has its own estimate, the threshold creeps up a node at a time and it runs several times slower than A*.
+template <class graph_type, class heuristic, class stats_type = SearchStats_None>
+class Graph_SearchFringe
+{
+private:
+	typedef typename graph_type::EdgeType Edge;
+
+	static const int k_NotListed = -2;
+
+	//Everything a pass touches for a node, kept together
+	struct Entry
+	{
+		float cost; //FLT_MAX until reached
+		float estimate; //Heuristic, negative until first needed
+		int prev; //Fringe links; k_NotListed when off the fringe
+		int next;
+	};
+
+	const graph_type& m_Graph;
+	std::vector<Entry> m_Entries; //One per node plus the list head at index NumNodes()
+	std::vector<const Edge*> m_ShortestPathTree; //Edge each reached node was last reached by
+	int m_Head;
+	int m_FringeSize;
+	int m_StartNode;
+	int m_TargetNode;
+	bool m_PathFound;
+	int m_NodesSearched;
+	stats_type m_Stats;
+public:
+	Graph_SearchFringe(const graph_type& graph, int startNode, int target = -1)
+		: m_Graph(graph)
+		, m_Entries(graph.NumNodes() + 1)
+		, m_ShortestPathTree(graph.NumNodes(), nullptr)
+		, m_Head(graph.NumNodes())
+		, m_FringeSize(0)
+		, m_StartNode(startNode)
+		, m_TargetNode(target)
+		, m_PathFound(false)
+		, m_NodesSearched(0)
+	{
+		assert(target >= 0 && "<Graph_SearchFringe>: needs a target");
+
+		Search();
+	}
+
+	const std::vector<const Edge*>& GetAllPaths() const { return m_ShortestPathTree; } //Edge into every node reached
+	std::list<int> GetPathToTarget() const;
+	//Allocation-free versions: start first, empty if the target was not reached (see PathOutput.h)
+	void GetPathToTarget(std::vector<int>& a_path) const { WritePath(ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_path); }
+	int GetPathToTarget(int* a_buffer, int a_capacity) const { return WritePath(ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_buffer, a_capacity); }
+	void GetPathPositionsToTarget(std::vector<DirectX::XMFLOAT3>& a_positions) const { WritePathPositions(m_Graph, ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_positions); }
+	float GetCostToTarget() const { return m_PathFound ? m_Entries[m_TargetNode].cost : 0.f; }
+	int GetNodesSearched() const { return m_NodesSearched; }
+	const stats_type& GetStats() const { return m_Stats; }
+private:
+	Graph_SearchFringe(const Graph_SearchFringe&);
+	Graph_SearchFringe& operator=(const Graph_SearchFringe&);
+
+	int ParentOf(int a_node) const { return (a_node == m_StartNode || !m_ShortestPathTree[a_node]) ? invalid_node_index : m_ShortestPathTree[a_node]->From(); }
+	int ReachedTarget() const { return m_PathFound ? m_TargetNode : invalid_node_index; }
+
+	float HeuristicOf(int a_node)
+	{
+		Entry& entry = m_Entries[a_node];
+
+		if (entry.estimate < 0.f)
+		{
+			entry.estimate = heuristic::Calculate(m_Graph, m_TargetNode, a_node);
+		}
+
+		return entry.estimate;
+	}
+
+	void InsertAfter(int a_node, int a_position)
+	{
+		Entry& entry = m_Entries[a_node];
+		Entry& before = m_Entries[a_position];
+
+		entry.prev = a_position;
+		entry.next = before.next;
+		m_Entries[before.next].prev = a_node;
+		before.next = a_node;
+		++m_FringeSize;
+	}
+
+	void Unlink(int a_node)
+	{
+		Entry& entry = m_Entries[a_node];
+
+		m_Entries[entry.prev].next = entry.next;
+		m_Entries[entry.next].prev = entry.prev;
+		entry.prev = k_NotListed;
+		--m_FringeSize;
+	}
+
+	void Search();
+};
+
+template <class graph_type, class heuristic, class stats_type>
+std::list<int> Graph_SearchFringe<graph_type, heuristic, stats_type>::GetPathToTarget() const
+{
+	std::list<int> path;
+
+	for (int node = ReachedTarget(); node != invalid_node_index; node = ParentOf(node))
+	{
+		path.push_front(node);
+	}
+
+	return path;
+}
+
+template <class graph_type, class heuristic, class stats_type>
+void Graph_SearchFringe<graph_type, heuristic, stats_type>::Search()
+{
+	m_Stats.BeginSearch();
+
+	for (size_t n = 0; n < m_Entries.size(); ++n)
+	{
+		m_Entries[n].cost = FLT_MAX;
+		m_Entries[n].estimate = -1.f;
+		m_Entries[n].prev = k_NotListed;
+	}
+
+	//Circular list through the head entry
+	m_Entries[m_Head].prev = m_Head;
+	m_Entries[m_Head].next = m_Head;
+
+	m_Entries[m_StartNode].cost = 0.f;
+	InsertAfter(m_StartNode, m_Head);
+	m_Stats.OnHeapPush(m_FringeSize);
+
+	float threshold = HeuristicOf(m_StartNode);
+
+	while (m_FringeSize > 0)
+	{
+		float nextThreshold = FLT_MAX;
+		int node = m_Entries[m_Head].next;
+
+		while (node != m_Head)
+		{
+			const float cost = m_Entries[node].cost;
+			const float estimate = cost + HeuristicOf(node);
+
+			if (estimate > threshold)
+			{
+				//Later
+				if (estimate < nextThreshold)
+				{
+					nextThreshold = estimate;
+				}
+
+				node = m_Entries[node].next;
+				continue;
+			}
+
+			if (node == m_TargetNode)
+			{
+				m_PathFound = true;
+				m_Stats.EndSearch();
+				return;
+			}
+
+			++m_NodesSearched;
+			m_Stats.OnNodeExpanded();
+
+			typename graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, node);
+
+			for (const Edge* edge = ConstEdgeItr.begin(); !ConstEdgeItr.end(); edge = ConstEdgeItr.next())
+			{
+				m_Stats.OnEdgeRelaxed();
+
+				const int to = edge->To();
+				const float nextCost = cost + edge->Cost();
+
+				if (nextCost >= m_Entries[to].cost)
+				{
+					continue;
+				}
+
+				//Now: move or add the child right after this node so it comes up next in this pass
+				if (m_Entries[to].prev != k_NotListed)
+				{
+					Unlink(to);
+					m_Stats.OnDecreaseKey();
+				}
+				else
+				{
+					m_Stats.OnHeapPush(m_FringeSize + 1);
+				}
+
+				m_Entries[to].cost = nextCost;
+				m_ShortestPathTree[to] = edge;
+				InsertAfter(to, node);
+			}
+
+			const int next = m_Entries[node].next;
+			Unlink(node);
+			node = next;
+		}
+
+		threshold = nextThreshold;
+	}
+
+	m_Stats.EndSearch();
+}
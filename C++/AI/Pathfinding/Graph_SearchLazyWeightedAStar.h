@@ -0,0 +1,221 @@
+#pragma once
+
+#include "GraphEdgeCosts.h"
+#include "Heuristics.h"
+#include "PathOutput.h"
+#include "SearchStats.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <functional>
+#include <vector>
+#include <list>
+
+//Lazy Weighted A* (Cohen, Phillips & Likhachev 2015), for edge costs that are expensive to evaluate (EdgeCost_Lazy).
+//Expanding a node doesn't evaluate its edges: each successor goes on the open list with the edge's stored cost as an
+//optimistic stand-in. Only when that entry comes off the list is the real cost asked for, and the successor goes back
+//on with its true cost if that still beats what it has. Most successors of a search are never popped, so most edges are
+//never evaluated.
+//
+//The stored cost (Edge::Cost()) must be a lower bound on the callback's cost, e.g. the distance with hazards added on
+//top. Then, for a consistent heuristic, the path costs at most epsilon times the optimal one, as with
+//Graph_SearchAStar. A node can be on the open list several times (once per untried parent), so the open list is a
+//plain binary heap and entries that have been overtaken are skipped when popped.
+//
+//  auto costs = MakeLazyEdgeCost([&](int a_from, int a_to, float a_cost) { return a_cost + hazards.Sample(a_from, a_to); });
+//  Graph_SearchLazyWeightedAStar<NavGraph, Heuristic_Euclidean, decltype(costs)> search(graph, start, target, costs, 1.5f);
+template <class graph_type, class heuristic, class cost_type, class stats_type = SearchStats_None>
+class Graph_SearchLazyWeightedAStar
+{
+private:
+	typedef typename graph_type::EdgeType Edge;
+
+	struct Entry
+	{
+		float key; //Cost + epsilon * heuristic
+		float cost; //Optimistic until evaluated
+		int node;
+		int edgeIndex; //Policy edge number of the edge, for lazy entries
+		const Edge* edge; //Edge the node is reached by, null for the start
+		bool evaluated;
+
+		bool operator>(const Entry& a_other) const { return key > a_other.key; }
+	};
+
+	const graph_type& m_Graph;
+	std::vector<float> m_CostToNode; //Best evaluated cost, FLT_MAX until reached
+	std::vector<const Edge*> m_Parent;
+	std::vector<char> m_Closed;
+	std::vector<Entry> m_Open; //Min-heap on key
+	int m_StartNode;
+	int m_TargetNode;
+	bool m_PathFound;
+	int m_NodesSearched;
+	float m_Epsilon;
+	cost_type m_EdgeCosts;
+	stats_type m_Stats;
+public:
+	Graph_SearchLazyWeightedAStar(const graph_type& graph, int startNode, int target, const cost_type& costs, float epsilon = 1.f)
+		: m_Graph(graph)
+		, m_CostToNode(graph.NumNodes(), FLT_MAX)
+		, m_Parent(graph.NumNodes(), nullptr)
+		, m_Closed(graph.NumNodes(), 0)
+		, m_StartNode(startNode)
+		, m_TargetNode(target)
+		, m_PathFound(false)
+		, m_NodesSearched(0)
+		, m_Epsilon(epsilon)
+		, m_EdgeCosts(costs)
+	{
+		assert(target >= 0 && "<Graph_SearchLazyWeightedAStar>: needs a target");
+		assert(epsilon >= 1.f && "<Graph_SearchLazyWeightedAStar>: epsilon below 1");
+
+		Search();
+	}
+
+	const std::vector<const Edge*>& GetAllPaths() const { return m_Parent; } //Edge into every node reached by an evaluated path
+	std::list<int> GetPathToTarget() const;
+	//Allocation-free versions: start first, empty if the target was not reached (see PathOutput.h)
+	void GetPathToTarget(std::vector<int>& a_path) const { WritePath(ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_path); }
+	int GetPathToTarget(int* a_buffer, int a_capacity) const { return WritePath(ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_buffer, a_capacity); }
+	void GetPathPositionsToTarget(std::vector<DirectX::XMFLOAT3>& a_positions) const { WritePathPositions(m_Graph, ReachedTarget(), [this](int a_node) { return ParentOf(a_node); }, a_positions); }
+	bool IsPathFound() const { return m_PathFound; }
+	float GetCostToTarget() const { return m_PathFound ? m_CostToNode[m_TargetNode] : 0.f; }
+	int GetNodesSearched() const { return m_NodesSearched; }
+	float GetSuboptimalityBound() const { return m_Epsilon; }
+	const stats_type& GetStats() const { return m_Stats; }
+private:
+	Graph_SearchLazyWeightedAStar(const Graph_SearchLazyWeightedAStar&);
+	Graph_SearchLazyWeightedAStar& operator=(const Graph_SearchLazyWeightedAStar&);
+
+	int ParentOf(int a_node) const { return (a_node == m_StartNode || !m_Parent[a_node]) ? invalid_node_index : m_Parent[a_node]->From(); }
+	int ReachedTarget() const { return m_PathFound ? m_TargetNode : invalid_node_index; }
+
+	void Push(int a_node, float a_cost, const Edge* a_edge, int a_edgeIndex, bool a_evaluated)
+	{
+		Entry entry;
+		entry.key = a_cost + m_Epsilon * heuristic::Calculate(m_Graph, m_TargetNode, a_node);
+		entry.cost = a_cost;
+		entry.node = a_node;
+		entry.edgeIndex = a_edgeIndex;
+		entry.edge = a_edge;
+		entry.evaluated = a_evaluated;
+
+		m_Open.push_back(entry);
+		std::push_heap(m_Open.begin(), m_Open.end(), std::greater<Entry>());
+		m_Stats.OnHeapPush((int)m_Open.size());
+	}
+
+	void Search();
+};
+
+template <class graph_type, class heuristic, class cost_type, class stats_type>
+std::list<int> Graph_SearchLazyWeightedAStar<graph_type, heuristic, cost_type, stats_type>::GetPathToTarget() const
+{
+	std::list<int> path;
+
+	for (int node = ReachedTarget(); node != invalid_node_index; node = ParentOf(node))
+	{
+		path.push_front(node);
+	}
+
+	return path;
+}
+
+template <class graph_type, class heuristic, class cost_type, class stats_type>
+void Graph_SearchLazyWeightedAStar<graph_type, heuristic, cost_type, stats_type>::Search()
+{
+	m_Stats.BeginSearch();
+
+	m_CostToNode[m_StartNode] = 0.f;
+	Push(m_StartNode, 0.f, nullptr, 0, true);
+
+	while (!m_Open.empty())
+	{
+		std::pop_heap(m_Open.begin(), m_Open.end(), std::greater<Entry>());
+		const Entry entry = m_Open.back();
+		m_Open.pop_back();
+
+		const int node = entry.node;
+
+		if (m_Closed[node])
+		{
+			continue;
+		}
+
+		if (!entry.evaluated)
+		{
+			//Only worth evaluating if the optimistic cost beats the best evaluated one
+			if (entry.cost >= m_CostToNode[node])
+			{
+				continue;
+			}
+
+			const float cost = m_CostToNode[entry.edge->From()] + m_EdgeCosts.Cost(*entry.edge, entry.edgeIndex);
+
+			if (cost < m_CostToNode[node])
+			{
+				m_CostToNode[node] = cost;
+				m_Parent[node] = entry.edge;
+				Push(node, cost, entry.edge, entry.edgeIndex, true);
+			}
+
+			continue;
+		}
+
+		if (entry.cost > m_CostToNode[node])
+		{
+			continue; //Overtaken by a cheaper evaluated path
+		}
+
+		if (node == m_TargetNode)
+		{
+			m_PathFound = true;
+			break;
+		}
+
+		m_Closed[node] = 1;
+		++m_NodesSearched;
+		m_Stats.OnNodeExpanded();
+
+		typename graph_type::ConstEdgeIterator ConstEdgeItr(m_Graph, node);
+		int edgeIndex = m_EdgeCosts.FirstEdge(node);
+
+		for (const Edge* edge = ConstEdgeItr.begin(); !ConstEdgeItr.end(); edge = ConstEdgeItr.next(), ++edgeIndex)
+		{
+			const int to = edge->To();
+
+			if (m_Closed[to] || !m_EdgeCosts.Allows(to))
+			{
+				continue;
+			}
+
+			m_Stats.OnEdgeRelaxed();
+
+			//Costs this query has already paid for go straight in; the rest wait with their stored cost
+			if (m_EdgeCosts.IsEvaluated(*edge))
+			{
+				const float cost = m_CostToNode[node] + m_EdgeCosts.Cost(*edge, edgeIndex);
+
+				if (cost < m_CostToNode[to])
+				{
+					m_CostToNode[to] = cost;
+					m_Parent[to] = edge;
+					Push(to, cost, edge, edgeIndex, true);
+				}
+			}
+			else
+			{
+				const float optimisticCost = m_CostToNode[node] + (float)edge->Cost();
+
+				if (optimisticCost < m_CostToNode[to])
+				{
+					Push(to, optimisticCost, edge, edgeIndex, false);
+				}
+			}
+		}
+	}
+
+	m_Stats.EndSearch();
+}
@@ -0,0 +1,140 @@
+#include <AI/Pathfinding/GridClearance.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+GridClearance::GridClearance(const GridMask& a_mask)
+	: m_Width(a_mask.Width())
+	, m_Height(a_mask.Height())
+	, m_PaddedWidth(a_mask.Width() + 2)
+{
+	Update(a_mask);
+}
+
+namespace
+{
+	//Squared distance from a cell's centre to a blocked cell a_cells whole cells away along one axis, edge to centre
+	double AxisDistanceSq(int a_cells)
+	{
+		return a_cells ? (a_cells - 0.5) * (a_cells - 0.5) : 0.0;
+	}
+
+	//Lower envelope of the parabolas (s - q)^2 + a_values[q] for q in [0, a_count), read at s = j - 0.5 for j in
+	//[0, a_count] into a_envelope. a_vertex and a_boundary are scratch of a_count and a_count + 1 entries.
+	void LowerEnvelope(const double* a_values, int a_count, int* a_vertex, double* a_boundary, double* a_envelope)
+	{
+		int k = 0;
+		a_vertex[0] = 0;
+		a_boundary[0] = -DBL_MAX;
+		a_boundary[1] = DBL_MAX;
+
+		for (int q = 1; q < a_count; ++q)
+		{
+			double s;
+
+			for (;;)
+			{
+				const int v = a_vertex[k];
+				s = ((a_values[q] + (double)q * q) - (a_values[v] + (double)v * v)) / (2.0 * (q - v));
+
+				if (s > a_boundary[k])
+				{
+					break;
+				}
+
+				--k;
+			}
+
+			++k;
+			a_vertex[k] = q;
+			a_boundary[k] = s;
+			a_boundary[k + 1] = DBL_MAX;
+		}
+
+		k = 0;
+
+		for (int j = 0; j <= a_count; ++j)
+		{
+			const double s = j - 0.5;
+
+			while (a_boundary[k + 1] < s)
+			{
+				++k;
+			}
+
+			const int v = a_vertex[k];
+			a_envelope[j] = (s - v) * (s - v) + a_values[v];
+		}
+	}
+}
+
+void GridClearance::Update(const GridMask& a_mask)
+{
+	assert(a_mask.Width() == m_Width && a_mask.Height() == m_Height && "<GridClearance::Update>: mask size changed");
+
+	const int w = m_PaddedWidth;
+
+	m_Distance.assign(w * (m_Height + 2), 0);
+
+	//Columns: whole cells to the nearest blocked cell above or below, the border rows included
+	std::vector<int> column(m_Distance.size(), 0);
+
+	for (int y = 1; y <= m_Height; ++y)
+	{
+		for (int x = 1; x <= m_Width; ++x)
+		{
+			const int p = y * w + x;
+
+			column[p] = a_mask.IsWalkable(x - 1, y - 1) ? column[p - w] + 1 : 0;
+		}
+	}
+
+	for (int y = m_Height; y >= 1; --y)
+	{
+		for (int p = y * w + 1; p <= y * w + m_Width; ++p)
+		{
+			column[p] = std::min(column[p], column[p + w] + 1);
+		}
+	}
+
+	//Rows: the nearest blocked cell in any column is the lowest parabola over the columns' distances. Reading the
+	//envelope half a cell either side of a centre measures to the near edge of cells to the left or right; the cell's
+	//own column needs no horizontal step.
+	std::vector<double> values(w);
+	std::vector<double> envelope(w + 1);
+	std::vector<double> boundary(w + 1);
+	std::vector<int> vertex(w);
+
+	for (int y = 1; y <= m_Height; ++y)
+	{
+		for (int x = 0; x < w; ++x)
+		{
+			values[x] = AxisDistanceSq(column[y * w + x]);
+		}
+
+		LowerEnvelope(values.data(), w, vertex.data(), boundary.data(), envelope.data());
+
+		for (int x = 1; x <= m_Width; ++x)
+		{
+			if (values[x] > 0.0)
+			{
+				const double distanceSq = std::min(values[x], std::min(envelope[x], envelope[x + 1]));
+
+				m_Distance[y * w + x] = (uint32_t)(4.0 * distanceSq + 0.5);
+			}
+		}
+	}
+}
+
+float GridClearance::GetClearance(int a_x, int a_y) const
+{
+	return 0.5f * std::sqrt((float)m_Distance[(a_y + 1) * m_PaddedWidth + a_x + 1]);
+}
+
+//Clearance sqrt(d) / 2 >= radius
+uint32_t GridClearance::MinimumDistance(float a_radius)
+{
+	return (uint32_t)std::max(1.0, std::ceil(4.0 * a_radius * a_radius - 1e-4));
+}
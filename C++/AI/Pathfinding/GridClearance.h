@@ -0,0 +1,88 @@
+#pragma once
+
+#include <AI/Pathfinding/GraphEdgeCosts.h>
+#include <AI/Pathfinding/GridMask.h>
+
+#include <cstdint>
+#include <vector>
+
+//Per-cell clearance for agents of different sizes on one grid: the exact Euclidean distance from each walkable cell's
+//centre to the nearest point of a blocked cell or the map edge. Built with a separable distance transform, a column
+//sweep then a lower envelope of parabolas along each row (Felzenszwalb & Huttenlocher), so the whole map is a few
+//linear passes. The envelope is read half a cell to either side of each centre, which measures to the blocked cells'
+//edges rather than their centres.
+//
+//Distances are kept as four times the squared distance (a whole number) in the same padded layout as PaddedGrid, index
+//(y + 1) * PaddedWidth() + x + 1, with the border at 0, so grid kernels can test a neighbour's clearance by the index
+//they already have. Searches take an agent radius (in cells) through GridClearance_Radius (Grid_SearchAStar) or
+//EdgeCost_Clearance (graph searches over GraphGenerator grids), which treat cells the agent doesn't fit in as blocked.
+class GridClearance
+{
+public:
+	explicit GridClearance(const GridMask& a_mask);
+
+	//Recomputes every cell from a mask of the same size
+	void Update(const GridMask& a_mask);
+
+	int Width() const { return m_Width; }
+	int Height() const { return m_Height; }
+	int PaddedWidth() const { return m_PaddedWidth; }
+	int ToPadded(int a_cell) const { return (a_cell / m_Width + 1) * m_PaddedWidth + a_cell % m_Width + 1; }
+
+	//Radius in cells of the largest agent that can stand centred on the cell; 0 for blocked cells, 0.5 beside a wall
+	float GetClearance(int a_x, int a_y) const;
+
+	//Smallest padded distance a cell needs for an agent of a_radius cells. Radii up to half a cell fit any open cell.
+	static uint32_t MinimumDistance(float a_radius);
+	bool Fits(int a_padded, uint32_t a_minimumDistance) const { return m_Distance[a_padded] >= a_minimumDistance; }
+private:
+	int m_Width;
+	int m_Height;
+	int m_PaddedWidth;
+	std::vector<uint32_t> m_Distance; //Four times the squared distance to the nearest blocked cell
+};
+
+//Clearance policies for Grid_SearchAStar's clearance_type template parameter
+
+//Every open cell is usable (the default); the test folds away
+struct GridClearance_Any
+{
+	bool Fits(int) const { return true; }
+};
+
+//Only cells an agent of the given radius fits in
+class GridClearance_Radius
+{
+public:
+	GridClearance_Radius(const GridClearance& a_clearance, float a_radius)
+		: m_Clearance(&a_clearance)
+		, m_MinimumDistance(GridClearance::MinimumDistance(a_radius))
+	{
+	}
+
+	bool Fits(int a_padded) const { return m_Clearance->Fits(a_padded, m_MinimumDistance); }
+private:
+	const GridClearance* m_Clearance;
+	uint32_t m_MinimumDistance;
+};
+
+//Cost policy for Graph_SearchDijkstra and Graph_SearchAStar over a graph from GraphGenerator::GenerateGrid or
+//GenerateGridFromMask (node index = cell index): costs come from base_cost and edges into cells the agent doesn't fit in
+//are skipped. Only the cells are tested, so unlike GridClearance_Radius a diagonal edge is kept beside a corner cell the
+//agent doesn't fit in, as long as the graph has it. The start node is not tested.
+template <class base_cost = EdgeCost_Graph>
+class EdgeCost_Clearance : public base_cost
+{
+public:
+	EdgeCost_Clearance(const GridClearance& a_clearance, float a_radius, const base_cost& a_base = base_cost())
+		: base_cost(a_base)
+		, m_Clearance(a_clearance, a_radius)
+		, m_Grid(&a_clearance)
+	{
+	}
+
+	bool Allows(int a_to) const { return m_Clearance.Fits(m_Grid->ToPadded(a_to)); }
+private:
+	GridClearance_Radius m_Clearance;
+	const GridClearance* m_Grid;
+};
@@ -0,0 +1,249 @@
+#include <AI/Pathfinding/GridMask.h>
+
+#include <algorithm>
+#include <fstream>
+
+GridMask::GridMask() : m_Width(0), m_Height(0), m_WordsPerRow(0)
+{
+}
+
+GridMask::GridMask(int a_width, int a_height, bool a_walkable) : m_Width(0), m_Height(0), m_WordsPerRow(0)
+{
+	Resize(a_width, a_height, a_walkable);
+}
+
+void GridMask::Resize(int a_width, int a_height, bool a_walkable)
+{
+	m_Width = a_width;
+	m_Height = a_height;
+	m_WordsPerRow = (a_width + 63) >> 6;
+	m_Words.assign(m_WordsPerRow * a_height, 0ull);
+	m_Costs.clear();
+
+	if (a_walkable)
+	{
+		//set whole words, then clear the padding past the last column so it always reads as blocked
+		const uint64_t tailMask = (a_width & 63) ? ((1ull << (a_width & 63)) - 1) : ~0ull;
+
+		for (int y = 0; y < a_height; ++y)
+		{
+			uint64_t* row = &m_Words[y * m_WordsPerRow];
+
+			for (int w = 0; w < m_WordsPerRow; ++w) row[w] = ~0ull;
+
+			row[m_WordsPerRow - 1] &= tailMask;
+		}
+	}
+}
+
+void GridMask::SetWalkable(int a_x, int a_y, bool a_walkable)
+{
+	uint64_t& word = m_Words[a_y * m_WordsPerRow + (a_x >> 6)];
+	const uint64_t bit = 1ull << (a_x & 63);
+
+	if (a_walkable) word |= bit;
+	else word &= ~bit;
+}
+
+bool GridMask::CanMoveDiagonal(int a_x, int a_y, int a_dx, int a_dy, DiagonalMovement a_rule) const
+{
+	if (a_rule == diagonal_never || !IsWalkable(a_x, a_y) || !IsWalkable(a_x + a_dx, a_y + a_dy))
+	{
+		return false;
+	}
+
+	switch (a_rule)
+	{
+	case diagonal_one_side_open:
+		return IsWalkable(a_x + a_dx, a_y) || IsWalkable(a_x, a_y + a_dy);
+	case diagonal_both_sides_open:
+		return IsWalkable(a_x + a_dx, a_y) && IsWalkable(a_x, a_y + a_dy);
+	default:
+		return true;
+	}
+}
+
+bool GridMask::IsSpanWalkable(int a_y, int a_x0, int a_x1) const
+{
+	const uint64_t* row = Row(a_y);
+	const int firstWord = a_x0 >> 6;
+	const int lastWord = a_x1 >> 6;
+
+	for (int w = firstWord; w <= lastWord; ++w)
+	{
+		uint64_t bits = ~0ull;
+
+		if (w == firstWord) bits &= ~0ull << (a_x0 & 63);
+		if (w == lastWord) bits &= ~0ull >> (63 - (a_x1 & 63));
+
+		if ((row[w] & bits) != bits)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//Works row by row: the stretch of the line inside each row covers one contiguous span of cells, which is tested with
+//IsSpanWalkable. Coordinates are doubled so cell edges (2c) and centres (2c + 1) are integers, and x positions are kept
+//multiplied by the line's height so every span end is found exactly.
+bool GridMask::HasLineOfSight(int a_x0, int a_y0, int a_x1, int a_y1) const
+{
+	if (!IsWalkable(a_x0, a_y0) || !IsWalkable(a_x1, a_y1))
+	{
+		return false;
+	}
+
+	if (a_y0 > a_y1)
+	{
+		std::swap(a_x0, a_x1);
+		std::swap(a_y0, a_y1);
+	}
+
+	if (a_y0 == a_y1)
+	{
+		return IsSpanWalkable(a_y0, std::min(a_x0, a_x1), std::max(a_x0, a_x1));
+	}
+
+	const int64_t dx = 2 * (int64_t)(a_x1 - a_x0);
+	const int64_t dy = 2 * (int64_t)(a_y1 - a_y0);
+	const int64_t startX = 2 * (int64_t)a_x0 + 1;
+	const int64_t startY = 2 * (int64_t)a_y0 + 1;
+	const int64_t endY = 2 * (int64_t)a_y1 + 1;
+
+	for (int y = a_y0; y <= a_y1; ++y)
+	{
+		//Part of the line within this row, as x * dy at its two ends
+		const int64_t top = std::max<int64_t>(2 * y, startY);
+		const int64_t bottom = std::min<int64_t>(2 * y + 2, endY);
+		int64_t left = startX * dy + (top - startY) * dx;
+		int64_t right = startX * dy + (bottom - startY) * dx;
+
+		if (left > right)
+		{
+			std::swap(left, right);
+		}
+
+		//Every cell whose closed extent [2c, 2c + 2] overlaps [left, right] / dy
+		const int first = (int)((left + 2 * dy - 1) / (2 * dy)) - 1;
+		const int last = (int)(right / (2 * dy));
+
+		if (!IsSpanWalkable(y, first, last))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool GridMask::LoadRawMask(const char* a_fileName, int a_width, int a_height, unsigned char a_threshold)
+{
+	std::ifstream in(a_fileName, std::ios::binary);
+
+	if (!in)
+	{
+		return false;
+	}
+
+	Resize(a_width, a_height, false);
+
+	std::vector<unsigned char> row(a_width);
+
+	for (int y = 0; y < a_height; ++y)
+	{
+		if (!in.read(reinterpret_cast<char*>(&row[0]), a_width))
+		{
+			return false;
+		}
+
+		uint64_t* words = &m_Words[y * m_WordsPerRow];
+
+		for (int x = 0; x < a_width; ++x)
+		{
+			words[x >> 6] |= (uint64_t)(row[x] >= a_threshold) << (x & 63);
+		}
+	}
+
+	return true;
+}
+
+bool GridMask::LoadPackedMask(const char* a_fileName, int a_width, int a_height)
+{
+	std::ifstream in(a_fileName, std::ios::binary);
+
+	if (!in)
+	{
+		return false;
+	}
+
+	Resize(a_width, a_height, false);
+
+	const int bytesPerRow = (a_width + 7) >> 3;
+	std::vector<unsigned char> row(bytesPerRow);
+
+	for (int y = 0; y < a_height; ++y)
+	{
+		if (!in.read(reinterpret_cast<char*>(&row[0]), bytesPerRow))
+		{
+			return false;
+		}
+
+		uint64_t* words = &m_Words[y * m_WordsPerRow];
+
+		//bytes are LSB first, so byte b lands at bits 8b..8b+7 of the row
+		for (int b = 0; b < bytesPerRow; ++b)
+		{
+			words[b >> 3] |= (uint64_t)row[b] << ((b & 7) * 8);
+		}
+
+		if (a_width & 63)
+		{
+			words[m_WordsPerRow - 1] &= (1ull << (a_width & 63)) - 1;
+		}
+	}
+
+	return true;
+}
+
+bool GridMask::SavePackedMask(const char* a_fileName) const
+{
+	std::ofstream out(a_fileName, std::ios::binary);
+
+	if (!out)
+	{
+		return false;
+	}
+
+	const int bytesPerRow = (m_Width + 7) >> 3;
+	std::vector<unsigned char> row(bytesPerRow);
+
+	for (int y = 0; y < m_Height; ++y)
+	{
+		const uint64_t* words = Row(y);
+
+		for (int b = 0; b < bytesPerRow; ++b)
+		{
+			row[b] = (unsigned char)(words[b >> 3] >> ((b & 7) * 8));
+		}
+
+		out.write(reinterpret_cast<const char*>(&row[0]), bytesPerRow);
+	}
+
+	return out.good();
+}
+
+bool GridMask::LoadRawCosts(const char* a_fileName)
+{
+	std::ifstream in(a_fileName, std::ios::binary);
+
+	if (!in || NumCells() == 0)
+	{
+		return false;
+	}
+
+	m_Costs.resize(NumCells());
+
+	return (bool)in.read(reinterpret_cast<char*>(&m_Costs[0]), NumCells());
+}
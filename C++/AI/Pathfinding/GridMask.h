@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+//How diagonal moves between grid cells are allowed
+enum DiagonalMovement
+{
+	diagonal_never, //4-connected
+	diagonal_always, //8-connected, diagonals may cut past blocked corners
+	diagonal_one_side_open, //Diagonal allowed if at least one of the two orthogonal cells it passes is walkable
+	diagonal_both_sides_open //Diagonal allowed only if both orthogonal cells are walkable (no corner cutting)
+};
+
+//Bit-packed walkability mask with an optional 8-bit terrain cost layer. Cell (x, y) has y = 0 as the top row, matching
+//the node indices y * width + x produced by GraphGenerator. Each row is padded to whole 64 bit words so that line of
+//sight and scan code can test 64 cells at a time.
+class GridMask
+{
+public:
+	GridMask();
+	GridMask(int a_width, int a_height, bool a_walkable = true);
+
+	void Resize(int a_width, int a_height, bool a_walkable = true);
+
+	int Width() const { return m_Width; }
+	int Height() const { return m_Height; }
+	int NumCells() const { return m_Width * m_Height; }
+	int WordsPerRow() const { return m_WordsPerRow; }
+	int CellIndex(int a_x, int a_y) const { return a_y * m_Width + a_x; }
+
+	bool InBounds(int a_x, int a_y) const { return a_x >= 0 && a_y >= 0 && a_x < m_Width && a_y < m_Height; }
+
+	//Out of bounds cells count as blocked
+	bool IsWalkable(int a_x, int a_y) const
+	{
+		return InBounds(a_x, a_y) && ((m_Words[a_y * m_WordsPerRow + (a_x >> 6)] >> (a_x & 63)) & 1ull);
+	}
+	void SetWalkable(int a_x, int a_y, bool a_walkable);
+
+	const uint64_t* Row(int a_y) const { return &m_Words[a_y * m_WordsPerRow]; }
+
+	//Whether a diagonal step from (a_x, a_y) by (a_dx, a_dy) is allowed under a_rule. Both end cells must be walkable.
+	bool CanMoveDiagonal(int a_x, int a_y, int a_dx, int a_dy, DiagonalMovement a_rule) const;
+
+	//Whether cells a_x0 .. a_x1 (inclusive, in bounds) of row a_y are all walkable, tested a word at a time
+	bool IsSpanWalkable(int a_y, int a_x0, int a_x1) const;
+
+	//Whether the straight line between the centres of two cells only touches walkable cells. A line passing exactly
+	//through a cell corner touches all four cells around it, so sight lines never cut corners.
+	bool HasLineOfSight(int a_x0, int a_y0, int a_x1, int a_y1) const;
+
+	//Terrain costs. The cost byte is a multiplier on the step length; 0 (or no cost layer) counts as 1.
+	bool HasCosts() const { return !m_Costs.empty(); }
+	void EnableCosts(unsigned char a_defaultCost = 1) { m_Costs.assign(NumCells(), a_defaultCost); }
+	unsigned char GetCost(int a_x, int a_y) const { return m_Costs.empty() ? 1 : m_Costs[CellIndex(a_x, a_y)]; }
+	float GetCostMultiplier(int a_x, int a_y) const { unsigned char c = GetCost(a_x, a_y); return c ? (float)c : 1.f; }
+	void SetCost(int a_x, int a_y, unsigned char a_cost) { m_Costs[CellIndex(a_x, a_y)] = a_cost; }
+
+	//Raw headerless files, row by row from the top.
+	//8 bits per cell: cells >= a_threshold are walkable
+	bool LoadRawMask(const char* a_fileName, int a_width, int a_height, unsigned char a_threshold = 1);
+	//1 bit per cell, least significant bit first, each row padded to a whole byte
+	bool LoadPackedMask(const char* a_fileName, int a_width, int a_height);
+	bool SavePackedMask(const char* a_fileName) const;
+	//8 bits per cell cost layer, for a mask already sized
+	bool LoadRawCosts(const char* a_fileName);
+private:
+	std::vector<uint64_t> m_Words;
+	std::vector<unsigned char> m_Costs;
+	int m_Width;
+	int m_Height;
+	int m_WordsPerRow;
+};
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <AI/Pathfinding/GridClearance.h>
+#include <AI/Pathfinding/GridMask.h>
+#include <AI/Pathfinding/PaddedGrid.h>
+#include <AI/Pathfinding/PathOutput.h>
+#include <AI/Pathfinding/PriorityQueue.h>
+#include <AI/Pathfinding/SearchStats.h>
+
+#include <cstdlib>
+#include <list>
+#include <vector>
+
+//Neighbourhood of a grid cell, fixed at compile time. The first four neighbours are cardinal, the rest diagonal; a
+//diagonal lists the two cardinal neighbours it passes between so the corner rule can test them.
+template <DiagonalMovement rule>
+struct GridConnectivity
+{
+	static const DiagonalMovement Rule = rule;
+	static const int NumNeighbours = (rule == diagonal_never) ? 4 : 8;
+
+	static constexpr int k_OffsetX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+	static constexpr int k_OffsetY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+	static constexpr int k_SideA[8] = { -1, -1, -1, -1, 0, 0, 1, 1 }; //Cardinal sharing the diagonal's x step
+	static constexpr int k_SideB[8] = { -1, -1, -1, -1, 2, 3, 2, 3 }; //Cardinal sharing the diagonal's y step
+
+	static bool IsDiagonal(int a_neighbour) { return a_neighbour >= 4; }
+
+	//a_sideA / a_sideB are whether the two cardinal cells beside the diagonal step are open
+	static bool DiagonalAllowed(bool a_sideA, bool a_sideB)
+	{
+		return rule == diagonal_always ||
+			(rule == diagonal_one_side_open && (a_sideA || a_sideB)) ||
+			(rule == diagonal_both_sides_open && a_sideA && a_sideB);
+	}
+};
+
+template <DiagonalMovement rule> constexpr int GridConnectivity<rule>::k_OffsetX[8];
+template <DiagonalMovement rule> constexpr int GridConnectivity<rule>::k_OffsetY[8];
+template <DiagonalMovement rule> constexpr int GridConnectivity<rule>::k_SideA[8];
+template <DiagonalMovement rule> constexpr int GridConnectivity<rule>::k_SideB[8];
+
+typedef GridConnectivity<diagonal_never> GridConnectivity4;
+typedef GridConnectivity<diagonal_both_sides_open> GridConnectivity8;
+
+//Cost models. StepCost gets the padded cells and the neighbour slot; Heuristic gets the absolute cell deltas to the
+//target and must be consistent with StepCost for the connectivity used.
+
+//Every step costs 1, diagonals included (the costs GraphGenerator::GenerateGrid uses)
+struct GridCost_Uniform
+{
+	static float StepCost(const PaddedGrid&, int, int, int) { return 1.f; }
+
+	template <class connectivity>
+	static float Heuristic(int a_dx, int a_dy)
+	{
+		return (float)(connectivity::NumNeighbours == 4 ? a_dx + a_dy : (a_dx > a_dy ? a_dx : a_dy));
+	}
+};
+
+//Cardinal steps cost 1 and diagonal steps sqrt(2)
+struct GridCost_Octile
+{
+	static float StepLength(int a_neighbour) { return a_neighbour < 4 ? 1.f : 1.41421356f; }
+
+	static float StepCost(const PaddedGrid&, int, int, int a_neighbour) { return StepLength(a_neighbour); }
+
+	template <class connectivity>
+	static float Heuristic(int a_dx, int a_dy)
+	{
+		if (connectivity::NumNeighbours == 4)
+		{
+			return (float)(a_dx + a_dy);
+		}
+
+		return (a_dx > a_dy) ? a_dx + 0.41421356f * a_dy : a_dy + 0.41421356f * a_dx;
+	}
+};
+
+//Octile step length scaled by the average terrain multiplier of the two cells, as GenerateGridFromMask does
+struct GridCost_Terrain
+{
+	static float StepCost(const PaddedGrid& a_grid, int a_from, int a_to, int a_neighbour)
+	{
+		return GridCost_Octile::StepLength(a_neighbour) * 0.5f * (a_grid.CostMultiplier(a_from) + a_grid.CostMultiplier(a_to));
+	}
+
+	//Multipliers are at least 1, so the unscaled distance stays admissible
+	template <class connectivity>
+	static float Heuristic(int a_dx, int a_dy) { return GridCost_Octile::Heuristic<connectivity>(a_dx, a_dy); }
+};
+
+//A* straight over a PaddedGrid. Neighbour offsets, corner rules and step costs come from the template parameters, so
+//the neighbour loop unrolls into straight-line code with no edge lists, iterators or indirect calls. Start, target and
+//path entries are cell indices (y * width + x), the same indices GraphGenerator gives grid nodes.
+//
+//clearance_type limits the search to cells an agent fits in (GridClearance_Radius), so one grid serves every agent
+//size. Cells that fail count as blocked throughout, corner rule included. With GridClearance_Any the test folds away.
+template <class connectivity, class cost_model = GridCost_Octile, class stats_type = SearchStats_None, class clearance_type = GridClearance_Any>
+class Grid_SearchAStar
+{
+private:
+	enum
+	{
+		unseen,
+		open,
+		closed
+	};
+
+	const PaddedGrid& m_Grid;
+	std::vector<float> m_CostToNode; //Per padded cell
+	std::vector<float> m_EstimatedCost; //Cost to node + heuristic, keys for the open list
+	std::vector<int> m_Parent; //Padded parent cell
+	std::vector<unsigned char> m_State;
+	int m_Offsets[8]; //Padded index offset of each neighbour
+	int m_StartNode; //Padded
+	int m_TargetNode; //Padded
+	bool m_PathFound;
+	int m_NodesSearched;
+	stats_type m_Stats;
+	clearance_type m_Clearance;
+public:
+	Grid_SearchAStar(const PaddedGrid& grid, int startCell, int targetCell, const clearance_type& clearance = clearance_type())
+		: m_Grid(grid)
+		, m_CostToNode(grid.NumPaddedCells(), 0.f)
+		, m_EstimatedCost(grid.NumPaddedCells(), 0.f)
+		, m_Parent(grid.NumPaddedCells(), invalid_node_index)
+		, m_State(grid.NumPaddedCells(), unseen)
+		, m_StartNode(grid.ToPadded(startCell))
+		, m_TargetNode(grid.ToPadded(targetCell))
+		, m_PathFound(false)
+		, m_NodesSearched(0)
+		, m_Clearance(clearance)
+	{
+		for (int i = 0; i < 8; ++i)
+		{
+			m_Offsets[i] = connectivity::k_OffsetX[i] + connectivity::k_OffsetY[i] * grid.PaddedWidth();
+		}
+
+		Search();
+	}
+
+	bool IsPathFound() const { return m_PathFound; }
+	float GetCostToTarget() const { return m_PathFound ? m_CostToNode[m_TargetNode] : 0.f; }
+	int GetNodesSearched() const { return m_NodesSearched; }
+	const stats_type& GetStats() const { return m_Stats; }
+
+	std::list<int> GetPathToTarget() const; //Cells from start to target, empty if no path
+	void GetPathToTarget(std::vector<int>& a_path) const { WritePath(m_PathFound ? m_TargetNode : invalid_node_index, [this](int a_node) { return m_Parent[a_node]; }, a_path); ToCells(a_path); }
+private:
+	void Search();
+	bool IsPassable(int a_padded) const { return m_Grid.IsOpen(a_padded) && m_Clearance.Fits(a_padded); }
+	void ToCells(std::vector<int>& a_path) const
+	{
+		for (size_t i = 0; i < a_path.size(); ++i)
+		{
+			a_path[i] = m_Grid.FromPadded(a_path[i]);
+		}
+	}
+	float Heuristic(int a_node, int a_targetX, int a_targetY) const
+	{
+		return cost_model::template Heuristic<connectivity>(std::abs(m_Grid.PaddedX(a_node) - a_targetX), std::abs(m_Grid.PaddedY(a_node) - a_targetY));
+	}
+};
+
+template <class connectivity, class cost_model, class stats_type, class clearance_type>
+std::list<int> Grid_SearchAStar<connectivity, cost_model, stats_type, clearance_type>::GetPathToTarget() const
+{
+	std::list<int> path;
+
+	if (!m_PathFound)
+	{
+		return path;
+	}
+
+	for (int node = m_TargetNode; node != invalid_node_index; node = m_Parent[node])
+	{
+		path.push_front(m_Grid.FromPadded(node));
+	}
+
+	return path;
+}
+
+template <class connectivity, class cost_model, class stats_type, class clearance_type>
+void Grid_SearchAStar<connectivity, cost_model, stats_type, clearance_type>::Search()
+{
+	m_Stats.BeginSearch();
+
+	if (!IsPassable(m_StartNode) || !IsPassable(m_TargetNode))
+	{
+		m_Stats.EndSearch();
+		return;
+	}
+
+	const int targetX = m_Grid.PaddedX(m_TargetNode);
+	const int targetY = m_Grid.PaddedY(m_TargetNode);
+
+	IndexedPriorityQLow<float> priorityQueue(m_EstimatedCost, m_Grid.NumPaddedCells());
+
+	m_EstimatedCost[m_StartNode] = Heuristic(m_StartNode, targetX, targetY);
+	m_State[m_StartNode] = open;
+	priorityQueue.insert(m_StartNode);
+	m_Stats.OnHeapPush(priorityQueue.size());
+
+	while (!priorityQueue.empty())
+	{
+		const int node = priorityQueue.Pop();
+
+		m_State[node] = closed;
+		++m_NodesSearched;
+		m_Stats.OnNodeExpanded();
+
+		if (node == m_TargetNode)
+		{
+			m_PathFound = true;
+			break;
+		}
+
+		//NumNeighbours and the offset tables are compile time constants, so this unrolls and the corner rule and
+		//cost model branches fold away. The blocked border means no bounds checks.
+		for (int i = 0; i < connectivity::NumNeighbours; ++i)
+		{
+			const int neighbour = node + m_Offsets[i];
+
+			if (!IsPassable(neighbour) || m_State[neighbour] == closed)
+			{
+				continue;
+			}
+
+			if (connectivity::IsDiagonal(i) &&
+				!connectivity::DiagonalAllowed(IsPassable(node + m_Offsets[connectivity::k_SideA[i]]), IsPassable(node + m_Offsets[connectivity::k_SideB[i]])))
+			{
+				continue;
+			}
+
+			m_Stats.OnEdgeRelaxed();
+
+			const float cost = m_CostToNode[node] + cost_model::StepCost(m_Grid, node, neighbour, i);
+
+			if (m_State[neighbour] == unseen)
+			{
+				m_CostToNode[neighbour] = cost;
+				m_EstimatedCost[neighbour] = cost + Heuristic(neighbour, targetX, targetY);
+				m_Parent[neighbour] = node;
+				m_State[neighbour] = open;
+
+				priorityQueue.insert(neighbour);
+				m_Stats.OnHeapPush(priorityQueue.size());
+			}
+			else if (cost < m_CostToNode[neighbour])
+			{
+				m_EstimatedCost[neighbour] += cost - m_CostToNode[neighbour];
+				m_CostToNode[neighbour] = cost;
+				m_Parent[neighbour] = node;
+
+				priorityQueue.ChangePriority(neighbour);
+				m_Stats.OnDecreaseKey();
+			}
+		}
+	}
+
+	m_Stats.EndSearch();
+}
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <AI/Pathfinding/GridMask.h>
+#include <AI/Pathfinding/Grid_SearchAStar.h>
+#include <AI/Pathfinding/PathOutput.h>
+#include <AI/Pathfinding/PriorityQueue.h>
+#include <AI/Pathfinding/SearchStats.h>
+
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+//Any-angle grid search (Lazy Theta*, Nash, Koenig & Tovey 2010). Runs like A* over the grid moves of the connectivity,
+//but a node reached from a neighbour takes that neighbour's parent as its own parent, so paths are straight lines
+//between waypoints at any angle, with no smoothing pass afterwards. Line of sight to the inherited parent is only checked
+//when the node is expanded (one GridMask::HasLineOfSight per expansion rather than one per neighbour as in Theta*); if
+//it fails, the node falls back to its best expanded grid neighbour.
+//
+//Costs are Euclidean distances between cell centres, in cells; terrain costs are ignored. Start, target and waypoints
+//are cell indices (y * width + x).
+template <class connectivity = GridConnectivity8, class stats_type = SearchStats_None>
+class Grid_SearchLazyThetaStar
+{
+private:
+	enum
+	{
+		unseen,
+		open,
+		closed
+	};
+
+	const GridMask& m_Mask;
+	std::vector<float> m_CostToNode;
+	std::vector<float> m_EstimatedCost; //Cost to node + straight line distance to the target, keys for the open list
+	std::vector<int> m_Parent; //Previous waypoint; the start node is its own parent
+	std::vector<unsigned char> m_State;
+	int m_StartNode;
+	int m_TargetNode;
+	bool m_PathFound;
+	int m_NodesSearched;
+	int m_LineOfSightChecks;
+	stats_type m_Stats;
+public:
+	Grid_SearchLazyThetaStar(const GridMask& mask, int startCell, int targetCell)
+		: m_Mask(mask)
+		, m_CostToNode(mask.NumCells(), 0.f)
+		, m_EstimatedCost(mask.NumCells(), 0.f)
+		, m_Parent(mask.NumCells(), invalid_node_index)
+		, m_State(mask.NumCells(), unseen)
+		, m_StartNode(startCell)
+		, m_TargetNode(targetCell)
+		, m_PathFound(false)
+		, m_NodesSearched(0)
+		, m_LineOfSightChecks(0)
+	{
+		Search();
+	}
+
+	bool IsPathFound() const { return m_PathFound; }
+	float GetCostToTarget() const { return m_PathFound ? m_CostToNode[m_TargetNode] : 0.f; }
+	int GetNodesSearched() const { return m_NodesSearched; }
+	int GetLineOfSightChecks() const { return m_LineOfSightChecks; }
+	const stats_type& GetStats() const { return m_Stats; }
+
+	//Waypoint cells from start to target; consecutive waypoints are in line of sight. Empty if no path.
+	void GetPathToTarget(std::vector<int>& a_waypoints) const { WritePath(m_PathFound ? m_TargetNode : invalid_node_index, [this](int a_node) { return ParentOf(a_node); }, a_waypoints); }
+private:
+	int ParentOf(int a_node) const { return a_node == m_StartNode ? invalid_node_index : m_Parent[a_node]; }
+
+	float Distance(int a_from, int a_to) const
+	{
+		const float dx = (float)(a_from % m_Mask.Width() - a_to % m_Mask.Width());
+		const float dy = (float)(a_from / m_Mask.Width() - a_to / m_Mask.Width());
+
+		return std::sqrt(dx * dx + dy * dy);
+	}
+
+	bool LineOfSight(int a_from, int a_to)
+	{
+		++m_LineOfSightChecks;
+
+		return m_Mask.HasLineOfSight(a_from % m_Mask.Width(), a_from / m_Mask.Width(), a_to % m_Mask.Width(), a_to / m_Mask.Width());
+	}
+
+	//Cell of neighbour slot a_neighbour if the grid move there is allowed, otherwise invalid_node_index
+	int Neighbour(int a_node, int a_neighbour) const
+	{
+		const int x = a_node % m_Mask.Width();
+		const int y = a_node / m_Mask.Width();
+		const int dx = connectivity::k_OffsetX[a_neighbour];
+		const int dy = connectivity::k_OffsetY[a_neighbour];
+
+		if (!m_Mask.IsWalkable(x + dx, y + dy))
+		{
+			return invalid_node_index;
+		}
+
+		if (connectivity::IsDiagonal(a_neighbour) && !connectivity::DiagonalAllowed(m_Mask.IsWalkable(x + dx, y), m_Mask.IsWalkable(x, y + dy)))
+		{
+			return invalid_node_index;
+		}
+
+		return m_Mask.CellIndex(x + dx, y + dy);
+	}
+
+	void Search();
+};
+
+template <class connectivity, class stats_type>
+void Grid_SearchLazyThetaStar<connectivity, stats_type>::Search()
+{
+	m_Stats.BeginSearch();
+
+	const int width = m_Mask.Width();
+
+	if (!m_Mask.IsWalkable(m_StartNode % width, m_StartNode / width) || !m_Mask.IsWalkable(m_TargetNode % width, m_TargetNode / width))
+	{
+		m_Stats.EndSearch();
+		return;
+	}
+
+	IndexedPriorityQLow<float> priorityQueue(m_EstimatedCost, m_Mask.NumCells());
+
+	m_Parent[m_StartNode] = m_StartNode;
+	m_EstimatedCost[m_StartNode] = Distance(m_StartNode, m_TargetNode);
+	m_State[m_StartNode] = open;
+	priorityQueue.insert(m_StartNode);
+	m_Stats.OnHeapPush(priorityQueue.size());
+
+	while (!priorityQueue.empty())
+	{
+		const int node = priorityQueue.Pop();
+
+		//The node was queued assuming it can see its parent. If it can't, take the cheapest path through an expanded
+		//grid neighbour instead; there is always one, since the node was reached from one.
+		if (m_Parent[node] != node && !LineOfSight(m_Parent[node], node))
+		{
+			float bestCost = FLT_MAX;
+
+			for (int i = 0; i < connectivity::NumNeighbours; ++i)
+			{
+				const int neighbour = Neighbour(node, i);
+
+				if (neighbour != invalid_node_index && m_State[neighbour] == closed)
+				{
+					const float cost = m_CostToNode[neighbour] + GridCost_Octile::StepLength(i);
+
+					if (cost < bestCost)
+					{
+						bestCost = cost;
+						m_Parent[node] = neighbour;
+					}
+				}
+			}
+
+			m_CostToNode[node] = bestCost;
+		}
+
+		m_State[node] = closed;
+		++m_NodesSearched;
+		m_Stats.OnNodeExpanded();
+
+		if (node == m_TargetNode)
+		{
+			m_PathFound = true;
+			break;
+		}
+
+		const int parent = m_Parent[node];
+
+		for (int i = 0; i < connectivity::NumNeighbours; ++i)
+		{
+			const int neighbour = Neighbour(node, i);
+
+			if (neighbour == invalid_node_index || m_State[neighbour] == closed)
+			{
+				continue;
+			}
+
+			m_Stats.OnEdgeRelaxed();
+
+			//Optimistically go straight from this node's parent
+			const float cost = m_CostToNode[parent] + Distance(parent, neighbour);
+
+			if (m_State[neighbour] == unseen)
+			{
+				m_CostToNode[neighbour] = cost;
+				m_EstimatedCost[neighbour] = cost + Distance(neighbour, m_TargetNode);
+				m_Parent[neighbour] = parent;
+				m_State[neighbour] = open;
+
+				priorityQueue.insert(neighbour);
+				m_Stats.OnHeapPush(priorityQueue.size());
+			}
+			else if (cost < m_CostToNode[neighbour])
+			{
+				m_EstimatedCost[neighbour] += cost - m_CostToNode[neighbour];
+				m_CostToNode[neighbour] = cost;
+				m_Parent[neighbour] = parent;
+
+				priorityQueue.ChangePriority(neighbour);
+				m_Stats.OnDecreaseKey();
+			}
+		}
+	}
+
+	m_Stats.EndSearch();
+}
@@ -10,7 +10,7 @@ public:
 	static float Calculate(const graph_type& a_graph, const int& a_node1, const int& a_node2) //Returns straight line distance between two nodes
 	{
 		DirectX::XMFLOAT3 distance;
-		DirectX::XMStoreFloat3(&distance, DirectX::XMVector3Length(DirectX::XMVectorSubtract((a_graph.GetNode(a_node1).GetPosition(), a_graph.GetNode(a_node2).GetPosition()))));
+		DirectX::XMStoreFloat3(&distance, DirectX::XMVector3Length(DirectX::XMVectorSubtract(a_graph.GetNode(a_node1).GetPosition(), a_graph.GetNode(a_node2).GetPosition())));
 		return distance.x;
 	}
 private:
@@ -28,4 +28,18 @@ public:
 	}
 private:
 	Heuristic_Manhatten() {}
-};
\ No newline at end of file
+};
+
+class Heuristic_Octile
+{
+public:
+	template <class graph_type>
+	static float Calculate(const graph_type& a_graph, const int& a_targetNode, const int& a_currentNode) //Returns 8-connected grid distance (diagonal steps cost sqrt(2)) between two nodes
+	{
+		float dx = fabs(DirectX::XMVectorGetX(a_graph.GetNode(a_targetNode).GetPosition()) - DirectX::XMVectorGetX(a_graph.GetNode(a_currentNode).GetPosition()));
+		float dz = fabs(DirectX::XMVectorGetZ(a_graph.GetNode(a_targetNode).GetPosition()) - DirectX::XMVectorGetZ(a_graph.GetNode(a_currentNode).GetPosition()));
+		return (dx > dz) ? dx + 0.41421356f * dz : dz + 0.41421356f * dx;
+	}
+private:
+	Heuristic_Octile() {}
+};
@@ -0,0 +1,264 @@
+#include <AI/Pathfinding/InfluenceMap.h>
+
+#include <AI/Pathfinding/ThreadPool.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+	const int k_RowsPerChunk = 32;
+
+	//Decayed values below this are flushed to zero. Left alone they sink into denormals, which are many times slower
+	//to compute with and would soon cover the whole map.
+	const float k_FlushToZero = 1e-6f;
+
+	float Falloff(InfluenceFalloff a_falloff, float a_distance, float a_radius)
+	{
+		const float t = 1.f - a_distance / a_radius;
+
+		switch (a_falloff)
+		{
+		case falloff_constant:
+			return 1.f;
+		case falloff_quadratic:
+			return t * t;
+		default:
+			return t;
+		}
+	}
+}
+
+InfluenceMap::InfluenceMap(const GridValues& a_grid, int a_numLayers)
+	: m_Grid(a_grid)
+	, m_Width(a_grid.numCellsWidth)
+	, m_Height(a_grid.numCellsHeight)
+	, m_Stride(((a_grid.numCellsWidth + 3) & ~3) + 8)
+	, m_Layers(a_numLayers)
+{
+	const size_t size = (size_t)(m_Height + 2) * m_Stride;
+
+	for (size_t l = 0; l < m_Layers.size(); ++l)
+	{
+		m_Layers[l].decay = 1.f;
+		m_Layers[l].spread = 0.f;
+		m_Layers[l].stamps.assign(size, 0.f);
+		m_Layers[l].front = 0;
+	}
+}
+
+void InfluenceMap::SetLayerDynamics(int a_layer, float a_decay, float a_spread)
+{
+	Layer& layer = m_Layers[a_layer];
+
+	layer.decay = a_decay;
+	layer.spread = a_spread;
+
+	if (layer.IsDynamic() && layer.values[0].empty())
+	{
+		layer.values[0] = layer.stamps;
+		layer.values[1].assign(layer.stamps.size(), 0.f);
+		layer.front = 0;
+	}
+	else if (!layer.IsDynamic())
+	{
+		layer.values[0].clear();
+		layer.values[1].clear();
+	}
+}
+
+int InfluenceMap::CellOfPosition(const DirectX::XMFLOAT3& a_position) const
+{
+	const int x = (int)std::floor(a_position.x / m_Grid.cellResolutionWidth);
+	const int y = (int)std::floor((m_Grid.mapHeight - a_position.z) / m_Grid.cellResolutionHeight);
+
+	return (x < 0 || y < 0 || x >= m_Width || y >= m_Height) ? -1 : y * m_Width + x;
+}
+
+float InfluenceMap::GetValueAtPosition(int a_layer, const DirectX::XMFLOAT3& a_position) const
+{
+	const int cell = CellOfPosition(a_position);
+
+	return cell < 0 ? 0.f : GetValue(a_layer, cell);
+}
+
+int InfluenceMap::AddSource(int a_layer, const DirectX::XMFLOAT3& a_position, float a_strength, float a_radius, InfluenceFalloff a_falloff)
+{
+	assert(a_layer >= 0 && a_layer < NumLayers() && "<InfluenceMap::AddSource>: invalid layer");
+
+	Source source;
+	source.layer = a_layer;
+	source.position = a_position;
+	source.strength = a_strength;
+	source.radius = a_radius;
+	source.falloff = a_falloff;
+
+	int id;
+
+	if (m_FreeSources.empty())
+	{
+		id = (int)m_Sources.size();
+		m_Sources.push_back(source);
+	}
+	else
+	{
+		id = m_FreeSources.back();
+		m_FreeSources.pop_back();
+		m_Sources[id] = source;
+	}
+
+	Stamp(source, 1.f);
+
+	return id;
+}
+
+void InfluenceMap::MoveSource(int a_source, const DirectX::XMFLOAT3& a_position)
+{
+	assert(m_Sources[a_source].layer >= 0 && "<InfluenceMap::MoveSource>: source was removed");
+
+	Source& source = m_Sources[a_source];
+
+	Stamp(source, -1.f);
+	source.position = a_position;
+	Stamp(source, 1.f);
+}
+
+void InfluenceMap::SetSourceStrength(int a_source, float a_strength)
+{
+	assert(m_Sources[a_source].layer >= 0 && "<InfluenceMap::SetSourceStrength>: source was removed");
+
+	Source& source = m_Sources[a_source];
+
+	Stamp(source, -1.f);
+	source.strength = a_strength;
+	Stamp(source, 1.f);
+}
+
+void InfluenceMap::RemoveSource(int a_source)
+{
+	assert(m_Sources[a_source].layer >= 0 && "<InfluenceMap::RemoveSource>: source was removed");
+
+	Stamp(m_Sources[a_source], -1.f);
+	m_Sources[a_source].layer = -1;
+	m_FreeSources.push_back(a_source);
+}
+
+void InfluenceMap::RebuildStamps()
+{
+	for (size_t l = 0; l < m_Layers.size(); ++l)
+	{
+		std::fill(m_Layers[l].stamps.begin(), m_Layers[l].stamps.end(), 0.f);
+	}
+
+	for (size_t s = 0; s < m_Sources.size(); ++s)
+	{
+		if (m_Sources[s].layer >= 0)
+		{
+			Stamp(m_Sources[s], 1.f);
+		}
+	}
+}
+
+//Adds (or with a_sign -1 takes back) the source's footprint: every cell whose centre is inside the radius
+void InfluenceMap::Stamp(const Source& a_source, float a_sign)
+{
+	const float cellWidth = m_Grid.cellResolutionWidth;
+	const float cellHeight = m_Grid.cellResolutionHeight;
+
+	//Source position in cell units, y down from the top row
+	const float cx = a_source.position.x / cellWidth;
+	const float cy = (m_Grid.mapHeight - a_source.position.z) / cellHeight;
+
+	const int x0 = std::max(0, (int)std::floor(cx - a_source.radius / cellWidth));
+	const int x1 = std::min(m_Width - 1, (int)std::floor(cx + a_source.radius / cellWidth));
+	const int y0 = std::max(0, (int)std::floor(cy - a_source.radius / cellHeight));
+	const int y1 = std::min(m_Height - 1, (int)std::floor(cy + a_source.radius / cellHeight));
+
+	const float radiusSq = a_source.radius * a_source.radius;
+	const float strength = a_sign * a_source.strength;
+	float* stamps = &m_Layers[a_source.layer].stamps[0];
+
+	for (int y = y0; y <= y1; ++y)
+	{
+		const float dz = (y + 0.5f - cy) * cellHeight;
+
+		for (int x = x0; x <= x1; ++x)
+		{
+			const float dx = (x + 0.5f - cx) * cellWidth;
+			const float distanceSq = dx * dx + dz * dz;
+
+			if (distanceSq < radiusSq)
+			{
+				stamps[Index(x, y)] += strength * Falloff(a_source.falloff, std::sqrt(distanceSq), a_source.radius);
+			}
+		}
+	}
+}
+
+void InfluenceMap::Update(ThreadPool* a_pool)
+{
+	for (size_t l = 0; l < m_Layers.size(); ++l)
+	{
+		Layer& layer = m_Layers[l];
+
+		if (!layer.IsDynamic())
+		{
+			continue;
+		}
+
+		if (a_pool)
+		{
+			a_pool->ParallelFor(m_Height, k_RowsPerChunk, [this, &layer](int a_begin, int a_end) { PropagateRows(layer, a_begin, a_end); });
+		}
+		else
+		{
+			PropagateRows(layer, 0, m_Height);
+		}
+
+		layer.front ^= 1;
+	}
+}
+
+//back = max(stamps, decay * lerp(front, mean of the four neighbours, spread)), four cells per step. The last block of
+//a row can run into the right padding, which is cleared again so nothing leaks in from there.
+void InfluenceMap::PropagateRows(Layer& a_layer, int a_firstRow, int a_endRow) const
+{
+	using namespace DirectX;
+
+	const float* front = &a_layer.values[a_layer.front][0];
+	float* back = &a_layer.values[a_layer.front ^ 1][0];
+	const float* stamps = &a_layer.stamps[0];
+
+	const XMVECTOR decay = XMVectorReplicate(a_layer.decay);
+	const XMVECTOR spread = XMVectorReplicate(a_layer.spread);
+	const XMVECTOR quarter = XMVectorReplicate(0.25f);
+	const XMVECTOR flush = XMVectorReplicate(k_FlushToZero);
+	const XMVECTOR zero = XMVectorZero();
+	const int paddedWidth = (m_Width + 3) & ~3;
+
+	for (int y = a_firstRow; y < a_endRow; ++y)
+	{
+		const int rowStart = Index(0, y);
+
+		for (int i = rowStart; i < rowStart + paddedWidth; i += 4)
+		{
+			const XMVECTOR centre = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(front + i));
+			XMVECTOR mean = XMVectorAdd(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(front + i - 1)), XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(front + i + 1)));
+			mean = XMVectorAdd(mean, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(front + i - m_Stride)));
+			mean = XMVectorAdd(mean, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(front + i + m_Stride)));
+			mean = XMVectorMultiply(mean, quarter);
+
+			const XMVECTOR blended = XMVectorMultiply(XMVectorMultiplyAdd(XMVectorSubtract(mean, centre), spread, centre), decay);
+			const XMVECTOR kept = XMVectorSelect(blended, zero, XMVectorLess(blended, flush));
+			const XMVECTOR result = XMVectorMax(kept, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(stamps + i)));
+
+			XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(back + i), result);
+		}
+
+		for (int x = m_Width; x < paddedWidth; ++x)
+		{
+			back[rowStart + x] = 0.f;
+		}
+	}
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <AI/Pathfinding/GraphEdgeCosts.h>
+#include <AI/Pathfinding/GridValues.h>
+
+#include <vector>
+
+class ThreadPool;
+
+//How a source's strength falls off from its centre to its radius
+enum InfluenceFalloff
+{
+	falloff_constant,
+	falloff_linear,
+	falloff_quadratic //Strength * (1 - d / radius)^2, most of it close in
+};
+
+//Float layers over the cells of a grid (threat, friendly presence, danger, ...) for scoring positions and weighting
+//paths, in the same cell layout and world space as GraphGenerator's grids: cell (x, y) has y = 0 as the top row.
+//
+//Each layer keeps the sum of its sources' stamps. Adding, moving or removing a source only rewrites the cells under its
+//old and new footprints, so a layer of sources that sit still costs nothing per tick. A layer with decay below 1 or
+//spread above 0 is dynamic as well: every Update blends each cell towards the average of its four neighbours by the
+//spread, scales by the decay and keeps the larger of that and the stamps, so influence lingers and seeps outwards
+//after its source has gone. That pass runs four cells at a time with DirectXMath from the front buffer into the back
+//one, then swaps, so readers always see the last complete update. Dynamic layers expect non-negative sources, since
+//the stamps act as a floor.
+class InfluenceMap
+{
+public:
+	InfluenceMap(const GridValues& a_grid, int a_numLayers);
+
+	int Width() const { return m_Width; }
+	int Height() const { return m_Height; }
+	int NumLayers() const { return (int)m_Layers.size(); }
+
+	//a_decay is the fraction kept per Update, a_spread how far each cell moves towards its neighbours' average
+	void SetLayerDynamics(int a_layer, float a_decay, float a_spread);
+
+	//Sources are stamped at once. Radius is in world units; ids are reused after RemoveSource.
+	int AddSource(int a_layer, const DirectX::XMFLOAT3& a_position, float a_strength, float a_radius, InfluenceFalloff a_falloff = falloff_linear);
+	void MoveSource(int a_source, const DirectX::XMFLOAT3& a_position);
+	void SetSourceStrength(int a_source, float a_strength);
+	void RemoveSource(int a_source);
+
+	//Runs the decay and propagation pass over every dynamic layer, rows spread over a_pool if given
+	void Update(ThreadPool* a_pool = nullptr);
+
+	//Restamps every layer from its sources, clearing rounding left behind by many incremental moves
+	void RebuildStamps();
+
+	float GetValue(int a_layer, int a_x, int a_y) const { return Values(a_layer)[Index(a_x, a_y)]; }
+	float GetValue(int a_layer, int a_cell) const { return GetValue(a_layer, a_cell % m_Width, a_cell / m_Width); }
+	float GetValueAtPosition(int a_layer, const DirectX::XMFLOAT3& a_position) const; //0 off the map
+
+	//Tactical costs: sets each edge's cost to a_baseCosts[edge] * (1 + a_weight * the layer's mean value at its two
+	//ends), with nodes mapped to cells by position. With a non-negative weight and layer no cost drops below its base,
+	//so distance heuristics stay admissible. a_baseCosts holds the untouched costs in edge order (CaptureEdgeCosts).
+	template <class graph_type>
+	void ApplyToEdgeCosts(graph_type& a_graph, int a_layer, float a_weight, const std::vector<float>& a_baseCosts) const;
+	template <class graph_type>
+	static std::vector<float> CaptureEdgeCosts(const graph_type& a_graph);
+	//The same into a separate cost set, leaving the graph alone: a_costs = a_baseCosts scaled by the layer
+	template <class graph_type>
+	void ApplyToEdgeCosts(const graph_type& a_graph, int a_layer, float a_weight, const GraphEdgeCosts& a_baseCosts, GraphEdgeCosts& a_costs) const;
+private:
+	struct Layer
+	{
+		float decay;
+		float spread;
+		std::vector<float> stamps; //Sum of the sources' footprints
+		std::vector<float> values[2]; //Dynamic layers only
+		int front;
+
+		bool IsDynamic() const { return decay < 1.f || spread > 0.f; }
+	};
+
+	struct Source
+	{
+		int layer; //-1 once removed
+		DirectX::XMFLOAT3 position;
+		float strength;
+		float radius;
+		InfluenceFalloff falloff;
+	};
+
+	//Rows carry four cells of zero padding on the left and at least four on the right, with a zero row above and
+	//below, so the pass can read every neighbour without bounds checks
+	int Index(int a_x, int a_y) const { return (a_y + 1) * m_Stride + 4 + a_x; }
+	const float* Values(int a_layer) const
+	{
+		const Layer& layer = m_Layers[a_layer];
+		return layer.IsDynamic() ? &layer.values[layer.front][0] : &layer.stamps[0];
+	}
+	int CellOfPosition(const DirectX::XMFLOAT3& a_position) const; //-1 off the map
+	template <class graph_type>
+	void GetNodeMultipliers(const graph_type& a_graph, int a_layer, float a_weight, std::vector<float>& a_multipliers) const;
+
+	void Stamp(const Source& a_source, float a_sign);
+	void PropagateRows(Layer& a_layer, int a_firstRow, int a_endRow) const;
+
+	GridValues m_Grid;
+	int m_Width;
+	int m_Height;
+	int m_Stride;
+	std::vector<Layer> m_Layers;
+	std::vector<Source> m_Sources;
+	std::vector<int> m_FreeSources;
+};
+
+template <class graph_type>
+std::vector<float> InfluenceMap::CaptureEdgeCosts(const graph_type& a_graph)
+{
+	std::vector<float> costs;
+	costs.reserve(a_graph.NumEdges());
+
+	for (int n = 0; n < a_graph.NumNodes(); ++n)
+	{
+		typename graph_type::ConstEdgeIterator ConstEdgeItr(a_graph, n);
+
+		for (const typename graph_type::EdgeType* pE = ConstEdgeItr.begin(); !ConstEdgeItr.end(); pE = ConstEdgeItr.next())
+		{
+			costs.push_back((float)pE->Cost());
+		}
+	}
+
+	return costs;
+}
+
+//1 + a_weight * the layer's value under each node
+template <class graph_type>
+void InfluenceMap::GetNodeMultipliers(const graph_type& a_graph, int a_layer, float a_weight, std::vector<float>& a_multipliers) const
+{
+	const float* values = Values(a_layer);
+	a_multipliers.assign(a_graph.NumNodes(), 1.f);
+
+	for (int n = 0; n < a_graph.NumNodes(); ++n)
+	{
+		if (a_graph.isNodePresent(n))
+		{
+			const int cell = CellOfPosition(a_graph.GetNode(n).GetPositionF3());
+
+			a_multipliers[n] = cell < 0 ? 1.f : 1.f + a_weight * values[Index(cell % m_Width, cell / m_Width)];
+		}
+	}
+}
+
+template <class graph_type>
+void InfluenceMap::ApplyToEdgeCosts(graph_type& a_graph, int a_layer, float a_weight, const std::vector<float>& a_baseCosts) const
+{
+	std::vector<float> nodeMultiplier;
+	GetNodeMultipliers(a_graph, a_layer, a_weight, nodeMultiplier);
+
+	size_t edge = 0;
+
+	for (int n = 0; n < a_graph.NumNodes(); ++n)
+	{
+		typename graph_type::EdgeIterator EdgeItr(a_graph, n);
+
+		for (typename graph_type::EdgeType* pE = EdgeItr.begin(); !EdgeItr.end(); pE = EdgeItr.next())
+		{
+			pE->SetCost(a_baseCosts[edge++] * 0.5f * (nodeMultiplier[n] + nodeMultiplier[pE->To()]));
+		}
+	}
+}
+
+template <class graph_type>
+void InfluenceMap::ApplyToEdgeCosts(const graph_type& a_graph, int a_layer, float a_weight, const GraphEdgeCosts& a_baseCosts, GraphEdgeCosts& a_costs) const
+{
+	std::vector<float> nodeMultiplier;
+	GetNodeMultipliers(a_graph, a_layer, a_weight, nodeMultiplier);
+
+	a_costs.ScaleByNode(a_baseCosts, nodeMultiplier.data());
+}
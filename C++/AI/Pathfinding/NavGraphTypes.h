@@ -0,0 +1,85 @@
+#pragma once
+
+#include <AI/Pathfinding/NodeTypeEnumerations.h>
+
+#include <DirectXMath.h>
+
+#include <ostream>
+#include <type_traits>
+
+//Trivially copyable alternatives to NodeNavigation and GraphEdge. They provide the same accessors, so
+//SparseGraph, the searches and GraphGenerator accept them unchanged, but carry no vtable (and no
+//previous index), so an edge is 12 bytes instead of 24 and nodes and edges can be copied with memcpy.
+//
+//  typedef SparseGraph<NavNode, NavEdge> NavGraph;
+
+class NavNode
+{
+public:
+	NavNode() : m_Index(invalid_node_index), m_Position(0.f, 0.f, 0.f) {}
+	NavNode(int index) : m_Index(index), m_Position(0.f, 0.f, 0.f) {}
+	NavNode(int index, DirectX::XMFLOAT3 position) : m_Index(index), m_Position(position) {}
+
+	int Index() const { return m_Index; }
+	void SetIndex(int a_newIndex) { m_Index = a_newIndex; }
+
+	const DirectX::XMFLOAT3& GetPositionF3() const { return m_Position; }
+	DirectX::XMVECTOR GetPosition() const { return DirectX::XMLoadFloat3(&m_Position); }
+	void SetPosition(const DirectX::XMFLOAT3& a_position) { m_Position = a_position; }
+	void SetPosition(const DirectX::XMVECTOR& a_position) { DirectX::XMStoreFloat3(&m_Position, a_position); }
+private:
+	int m_Index;
+	DirectX::XMFLOAT3 m_Position;
+};
+
+class NavEdge
+{
+public:
+	NavEdge() : m_From(invalid_node_index), m_To(invalid_node_index), m_Cost(1.f) {}
+	NavEdge(int from, int to) : m_From(from), m_To(to), m_Cost(1.f) {}
+	NavEdge(int from, int to, float cost) : m_From(from), m_To(to), m_Cost(cost) {}
+
+	void Clear() { m_From = invalid_node_index; m_To = invalid_node_index; m_Cost = 1.f; }
+
+	void SetFromTo(int a_from, int a_to) { m_From = a_from; m_To = a_to; }
+	void SetFromToCost(int a_from, int a_to, float a_cost) { m_From = a_from; m_To = a_to; m_Cost = a_cost; }
+
+	int From() const { return m_From; }
+	void SetFrom(int a_newIndex) { m_From = a_newIndex; }
+
+	int To() const { return m_To; }
+	void SetTo(int a_newIndex) { m_To = a_newIndex; }
+
+	float Cost() const { return m_Cost; }
+	void SetCost(float a_newCost) { m_Cost = a_newCost; }
+
+	bool operator==(const NavEdge& a_rhs) const { return m_From == a_rhs.m_From && m_To == a_rhs.m_To && m_Cost == a_rhs.m_Cost; }
+	bool operator!=(const NavEdge& a_rhs) const { return !(*this == a_rhs); }
+
+	friend std::ostream& operator<<(std::ostream& a_os, const NavEdge& a_edge)
+	{
+		a_os << "From: " << a_edge.m_From << " To: " << a_edge.m_To << " Cost: " << a_edge.m_Cost << std::endl;
+		return a_os;
+	}
+private:
+	int m_From;
+	int m_To;
+	float m_Cost;
+};
+
+//Text form read back by SparseGraph::Load
+inline void SaveNode(std::ostream& a_os, const NavNode& a_node)
+{
+	a_os << "Index: " << a_node.Index() << " PosX: " << a_node.GetPositionF3().x << " PosZ: " << a_node.GetPositionF3().z << std::endl;
+}
+
+//Whether a node or edge type can be saved, loaded and copied as raw bytes (see SparseGraph::SaveBinary)
+template <class element_type>
+struct GraphElementTraits
+{
+	enum { is_bulk_copyable = std::is_trivially_copyable<element_type>::value };
+};
+
+static_assert(GraphElementTraits<NavNode>::is_bulk_copyable, "NavNode must stay trivially copyable");
+static_assert(GraphElementTraits<NavEdge>::is_bulk_copyable, "NavEdge must stay trivially copyable");
+static_assert(sizeof(NavEdge) == 12, "NavEdge should be three 4 byte fields");
@@ -0,0 +1,475 @@
+#include <AI/Pathfinding/NavMesh.h>
+
+#include <AI/Pathfinding/Graph_SearchAStar.h>
+#include <AI/Pathfinding/Heuristics.h>
+
+#include <cmath>
+#include <map>
+#include <utility>
+
+namespace
+{
+	//Twice the signed area of triangle (a, b, c) in the XZ plane
+	float TriArea2(const DirectX::XMFLOAT3& a_a, const DirectX::XMFLOAT3& a_b, const DirectX::XMFLOAT3& a_c)
+	{
+		const float abX = a_b.x - a_a.x;
+		const float abZ = a_b.z - a_a.z;
+		const float acX = a_c.x - a_a.x;
+		const float acZ = a_c.z - a_a.z;
+		return acX * abZ - abX * acZ;
+	}
+
+	bool SamePoint(const DirectX::XMFLOAT3& a_a, const DirectX::XMFLOAT3& a_b)
+	{
+		const float dx = a_a.x - a_b.x;
+		const float dz = a_a.z - a_b.z;
+		return dx * dx + dz * dz < 1e-12f;
+	}
+
+	float DistanceXZ(const DirectX::XMFLOAT3& a_a, const DirectX::XMFLOAT3& a_b)
+	{
+		const float dx = a_a.x - a_b.x;
+		const float dz = a_a.z - a_b.z;
+		return sqrtf(dx * dx + dz * dz);
+	}
+}
+
+NavMesh::NavMesh()
+	: m_Graph(true)
+	, m_MaskWidth(0)
+	, m_MaskHeight(0)
+	, m_CellWidth(1.f)
+	, m_CellHeight(1.f)
+	, m_LastNodesSearched(0)
+{
+}
+
+void NavMesh::Clear()
+{
+	m_Vertices.clear();
+	m_PolygonVertices.clear();
+	m_Polygons.clear();
+	m_Portals.clear();
+	m_Graph.Clear();
+	m_Graph.SetDigraph(true);
+	m_PolygonOfCell.clear();
+	m_MaskWidth = 0;
+	m_MaskHeight = 0;
+}
+
+int NavMesh::AddPolygon(const int* a_vertexIndices, int a_numVertices)
+{
+	Polygon polygon;
+	polygon.firstVertex = (int)m_PolygonVertices.size();
+	polygon.numVertices = a_numVertices;
+
+	DirectX::XMFLOAT3 centroid(0.f, 0.f, 0.f);
+
+	for (int i = 0; i < a_numVertices; ++i)
+	{
+		const DirectX::XMFLOAT3& vertex = m_Vertices[a_vertexIndices[i]];
+
+		m_PolygonVertices.push_back(a_vertexIndices[i]);
+		centroid.x += vertex.x / a_numVertices;
+		centroid.y += vertex.y / a_numVertices;
+		centroid.z += vertex.z / a_numVertices;
+	}
+
+	m_Polygons.push_back(polygon);
+	m_Portals.push_back(std::vector<Portal>());
+
+	return m_Graph.AddNode(NavNode(m_Graph.GetNextFreeNodeIndex(), centroid));
+}
+
+void NavMesh::AddPortal(int a_from, int a_to, const DirectX::XMFLOAT3& a_a, const DirectX::XMFLOAT3& a_b)
+{
+	Portal portal;
+	portal.neighbour = a_to;
+	portal.a = a_a;
+	portal.b = a_b;
+	m_Portals[a_from].push_back(portal);
+
+	portal.neighbour = a_from;
+	m_Portals[a_to].push_back(portal);
+
+	const float cost = DistanceXZ(m_Graph.GetNode(a_from).GetPositionF3(), m_Graph.GetNode(a_to).GetPositionF3());
+
+	m_Graph.AddEdge(NavEdge(a_from, a_to, cost));
+	m_Graph.AddEdge(NavEdge(a_to, a_from, cost));
+}
+
+void NavMesh::BuildFromPolygons(const std::vector<DirectX::XMFLOAT3>& a_vertices, const std::vector<std::vector<int> >& a_polygons)
+{
+	Clear();
+
+	m_Vertices = a_vertices;
+
+	//Edge (low vertex, high vertex) -> first polygon seen using it
+	std::map<std::pair<int, int>, int> edgeOwner;
+
+	for (size_t p = 0; p < a_polygons.size(); ++p)
+	{
+		const std::vector<int>& indices = a_polygons[p];
+
+		if (indices.size() < 3)
+		{
+			continue;
+		}
+
+		const int polygon = AddPolygon(&indices[0], (int)indices.size());
+
+		for (size_t i = 0; i < indices.size(); ++i)
+		{
+			const int v0 = indices[i];
+			const int v1 = indices[(i + 1) % indices.size()];
+			const std::pair<int, int> key(v0 < v1 ? v0 : v1, v0 < v1 ? v1 : v0);
+
+			std::map<std::pair<int, int>, int>::iterator owner = edgeOwner.find(key);
+
+			if (owner == edgeOwner.end())
+			{
+				edgeOwner[key] = polygon;
+			}
+			else
+			{
+				AddPortal(owner->second, polygon, m_Vertices[v0], m_Vertices[v1]);
+			}
+		}
+	}
+}
+
+void NavMesh::BuildFromMask(const GridMask& a_mask, float a_cellWidth, float a_cellHeight, int a_maxRectSize)
+{
+	Clear();
+
+	const int width = a_mask.Width();
+	const int height = a_mask.Height();
+	const float mapHeight = height * a_cellHeight;
+
+	m_MaskWidth = width;
+	m_MaskHeight = height;
+	m_CellWidth = a_cellWidth;
+	m_CellHeight = a_cellHeight;
+	m_PolygonOfCell.assign(a_mask.NumCells(), invalid_node_index);
+
+	//Greedy rectangles: take the first uncovered walkable cell, grow right as far as possible, then grow down while the
+	//whole row below is walkable and uncovered. Capping the size keeps centroids (and so the polygon graph's edge costs)
+	//close to where paths actually cross each rectangle.
+	struct Rect { int x0, y0, x1, y1; };
+	std::vector<Rect> rects;
+
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			if (!a_mask.IsWalkable(x, y) || m_PolygonOfCell[a_mask.CellIndex(x, y)] != invalid_node_index)
+			{
+				continue;
+			}
+
+			Rect rect = { x, y, x + 1, y + 1 };
+
+			while (rect.x1 < width && rect.x1 - rect.x0 < a_maxRectSize && a_mask.IsWalkable(rect.x1, y) && m_PolygonOfCell[a_mask.CellIndex(rect.x1, y)] == invalid_node_index)
+			{
+				++rect.x1;
+			}
+
+			for (bool rowFree = true; rowFree && rect.y1 < height && rect.y1 - rect.y0 < a_maxRectSize; )
+			{
+				for (int cx = rect.x0; cx < rect.x1 && rowFree; ++cx)
+				{
+					rowFree = a_mask.IsWalkable(cx, rect.y1) && m_PolygonOfCell[a_mask.CellIndex(cx, rect.y1)] == invalid_node_index;
+				}
+
+				if (rowFree)
+				{
+					++rect.y1;
+				}
+			}
+
+			const int polygon = (int)rects.size();
+
+			for (int cy = rect.y0; cy < rect.y1; ++cy)
+			{
+				for (int cx = rect.x0; cx < rect.x1; ++cx)
+				{
+					m_PolygonOfCell[a_mask.CellIndex(cx, cy)] = polygon;
+				}
+			}
+
+			rects.push_back(rect);
+		}
+	}
+
+	for (size_t r = 0; r < rects.size(); ++r)
+	{
+		const Rect& rect = rects[r];
+		const float left = rect.x0 * a_cellWidth;
+		const float right = rect.x1 * a_cellWidth;
+		const float top = mapHeight - rect.y0 * a_cellHeight;
+		const float bottom = mapHeight - rect.y1 * a_cellHeight;
+
+		int indices[4];
+		indices[0] = (int)m_Vertices.size();
+		m_Vertices.push_back(DirectX::XMFLOAT3(left, 0.f, top));
+		indices[1] = (int)m_Vertices.size();
+		m_Vertices.push_back(DirectX::XMFLOAT3(right, 0.f, top));
+		indices[2] = (int)m_Vertices.size();
+		m_Vertices.push_back(DirectX::XMFLOAT3(right, 0.f, bottom));
+		indices[3] = (int)m_Vertices.size();
+		m_Vertices.push_back(DirectX::XMFLOAT3(left, 0.f, bottom));
+
+		AddPolygon(indices, 4);
+	}
+
+	//Portals: walk the column right of each rectangle and the row below it, one portal per run of cells belonging to
+	//the same neighbour. Left and top borders are found from the other side.
+	for (size_t r = 0; r < rects.size(); ++r)
+	{
+		const Rect& rect = rects[r];
+
+		if (rect.x1 < width)
+		{
+			const float x = rect.x1 * a_cellWidth;
+
+			for (int y = rect.y0; y < rect.y1; )
+			{
+				const int neighbour = m_PolygonOfCell[a_mask.CellIndex(rect.x1, y)];
+				int runEnd = y + 1;
+
+				while (runEnd < rect.y1 && m_PolygonOfCell[a_mask.CellIndex(rect.x1, runEnd)] == neighbour)
+				{
+					++runEnd;
+				}
+
+				if (neighbour != invalid_node_index)
+				{
+					AddPortal((int)r, neighbour, DirectX::XMFLOAT3(x, 0.f, mapHeight - y * a_cellHeight), DirectX::XMFLOAT3(x, 0.f, mapHeight - runEnd * a_cellHeight));
+				}
+
+				y = runEnd;
+			}
+		}
+
+		if (rect.y1 < height)
+		{
+			const float z = mapHeight - rect.y1 * a_cellHeight;
+
+			for (int x = rect.x0; x < rect.x1; )
+			{
+				const int neighbour = m_PolygonOfCell[a_mask.CellIndex(x, rect.y1)];
+				int runEnd = x + 1;
+
+				while (runEnd < rect.x1 && m_PolygonOfCell[a_mask.CellIndex(runEnd, rect.y1)] == neighbour)
+				{
+					++runEnd;
+				}
+
+				if (neighbour != invalid_node_index)
+				{
+					AddPortal((int)r, neighbour, DirectX::XMFLOAT3(x * a_cellWidth, 0.f, z), DirectX::XMFLOAT3(runEnd * a_cellWidth, 0.f, z));
+				}
+
+				x = runEnd;
+			}
+		}
+	}
+}
+
+bool NavMesh::ContainsPoint(int a_polygon, float a_x, float a_z) const
+{
+	const Polygon& polygon = m_Polygons[a_polygon];
+	const DirectX::XMFLOAT3 point(a_x, 0.f, a_z);
+
+	//Convex, so the point is inside (or on the border) if it is never on opposite sides of two edges
+	bool positive = false;
+	bool negative = false;
+
+	for (int i = 0; i < polygon.numVertices; ++i)
+	{
+		const DirectX::XMFLOAT3& v0 = m_Vertices[m_PolygonVertices[polygon.firstVertex + i]];
+		const DirectX::XMFLOAT3& v1 = m_Vertices[m_PolygonVertices[polygon.firstVertex + (i + 1) % polygon.numVertices]];
+		const float area = TriArea2(v0, v1, point);
+
+		positive |= area > 0.f;
+		negative |= area < 0.f;
+	}
+
+	return !(positive && negative);
+}
+
+int NavMesh::FindPolygon(const DirectX::XMFLOAT3& a_position) const
+{
+	if (!m_PolygonOfCell.empty())
+	{
+		const int x = (int)floorf(a_position.x / m_CellWidth);
+		const int y = (int)floorf((m_MaskHeight * m_CellHeight - a_position.z) / m_CellHeight);
+
+		if (x < 0 || y < 0 || x >= m_MaskWidth || y >= m_MaskHeight)
+		{
+			return invalid_node_index;
+		}
+
+		return m_PolygonOfCell[y * m_MaskWidth + x];
+	}
+
+	for (int p = 0; p < (int)m_Polygons.size(); ++p)
+	{
+		if (ContainsPoint(p, a_position.x, a_position.z))
+		{
+			return p;
+		}
+	}
+
+	return invalid_node_index;
+}
+
+const NavMesh::Portal* NavMesh::FindPortal(int a_from, int a_to) const
+{
+	const std::vector<Portal>& portals = m_Portals[a_from];
+
+	for (size_t i = 0; i < portals.size(); ++i)
+	{
+		if (portals[i].neighbour == a_to)
+		{
+			return &portals[i];
+		}
+	}
+
+	return nullptr;
+}
+
+bool NavMesh::FindPath(const DirectX::XMFLOAT3& a_start, const DirectX::XMFLOAT3& a_goal, std::vector<DirectX::XMFLOAT3>& a_waypoints)
+{
+	a_waypoints.clear();
+	m_LastNodesSearched = 0;
+
+	const int startPolygon = FindPolygon(a_start);
+	const int goalPolygon = FindPolygon(a_goal);
+
+	if (startPolygon == invalid_node_index || goalPolygon == invalid_node_index)
+	{
+		return false;
+	}
+
+	if (startPolygon == goalPolygon)
+	{
+		m_PolygonPath.assign(1, startPolygon);
+	}
+	else
+	{
+		Graph_SearchAStar<GraphType, Heuristic_Euclidean> search(m_Graph, startPolygon, goalPolygon);
+		search.GetPathToTarget(m_PolygonPath);
+		m_LastNodesSearched = search.GetNodesSearched();
+
+		if (m_PolygonPath.empty())
+		{
+			return false;
+		}
+	}
+
+	//Funnel portals: the start as a zero width portal, the shared edge between each pair of polygons on the corridor
+	//oriented to the walking direction, then the goal
+	m_PortalLeft.assign(1, a_start);
+	m_PortalRight.assign(1, a_start);
+
+	for (size_t i = 1; i < m_PolygonPath.size(); ++i)
+	{
+		const Portal* portal = FindPortal(m_PolygonPath[i - 1], m_PolygonPath[i]);
+		const DirectX::XMFLOAT3& from = m_Graph.GetNode(m_PolygonPath[i - 1]).GetPositionF3();
+
+		if (TriArea2(from, portal->a, portal->b) < 0.f)
+		{
+			m_PortalLeft.push_back(portal->b);
+			m_PortalRight.push_back(portal->a);
+		}
+		else
+		{
+			m_PortalLeft.push_back(portal->a);
+			m_PortalRight.push_back(portal->b);
+		}
+	}
+
+	m_PortalLeft.push_back(a_goal);
+	m_PortalRight.push_back(a_goal);
+
+	StringPull(a_waypoints);
+
+	return true;
+}
+
+//Simple stupid funnel algorithm (Mononen): keep a funnel from the apex to the tightest left and right portal points
+//seen so far. When a side would cross over the other, that side's point becomes a waypoint and the new apex, and the
+//scan restarts from the portal after it.
+void NavMesh::StringPull(std::vector<DirectX::XMFLOAT3>& a_waypoints) const
+{
+	const int numPortals = (int)m_PortalLeft.size();
+
+	DirectX::XMFLOAT3 apex = m_PortalLeft[0];
+	DirectX::XMFLOAT3 left = m_PortalLeft[0];
+	DirectX::XMFLOAT3 right = m_PortalRight[0];
+	int apexIndex = 0;
+	int leftIndex = 0;
+	int rightIndex = 0;
+
+	a_waypoints.push_back(apex);
+
+	for (int i = 1; i < numPortals; ++i)
+	{
+		const DirectX::XMFLOAT3& portalLeft = m_PortalLeft[i];
+		const DirectX::XMFLOAT3& portalRight = m_PortalRight[i];
+
+		//Tighten the right side
+		if (TriArea2(apex, right, portalRight) <= 0.f)
+		{
+			if (SamePoint(apex, right) || TriArea2(apex, left, portalRight) > 0.f)
+			{
+				right = portalRight;
+				rightIndex = i;
+			}
+			else
+			{
+				//Right crossed over left: left becomes a waypoint and the new apex
+				apex = left;
+				apexIndex = leftIndex;
+				a_waypoints.push_back(apex);
+
+				left = apex;
+				right = apex;
+				leftIndex = apexIndex;
+				rightIndex = apexIndex;
+				i = apexIndex;
+				continue;
+			}
+		}
+
+		//Tighten the left side
+		if (TriArea2(apex, left, portalLeft) >= 0.f)
+		{
+			if (SamePoint(apex, left) || TriArea2(apex, right, portalLeft) < 0.f)
+			{
+				left = portalLeft;
+				leftIndex = i;
+			}
+			else
+			{
+				//Left crossed over right: right becomes a waypoint and the new apex
+				apex = right;
+				apexIndex = rightIndex;
+				a_waypoints.push_back(apex);
+
+				left = apex;
+				right = apex;
+				leftIndex = apexIndex;
+				rightIndex = apexIndex;
+				i = apexIndex;
+				continue;
+			}
+		}
+	}
+
+	if (!SamePoint(a_waypoints.back(), m_PortalLeft[numPortals - 1]))
+	{
+		a_waypoints.push_back(m_PortalLeft[numPortals - 1]);
+	}
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <AI/Pathfinding/GridMask.h>
+#include <AI/Pathfinding/NavGraphTypes.h>
+#include <AI/Pathfinding/SparseGraph.h>
+
+#include <vector>
+
+//Navigation mesh of convex polygons on the XZ plane. Each polygon is a node of a small adjacency graph (positioned at
+//its centroid) and each pair of touching polygons shares a portal segment. A query searches the polygon graph with
+//Graph_SearchAStar and string-pulls the corridor through its portals with the simple stupid funnel algorithm.
+class NavMesh
+{
+public:
+	typedef SparseGraph<NavNode, NavEdge> GraphType;
+
+	NavMesh();
+
+	//Polygon soup: each polygon lists indices into a_vertices and must be convex. Polygons sharing an edge (the same
+	//two vertex indices) are connected through it. Polygons with fewer than three vertices are skipped.
+	void BuildFromPolygons(const std::vector<DirectX::XMFLOAT3>& a_vertices, const std::vector<std::vector<int> >& a_polygons);
+
+	//Covers the walkable cells with rectangles of at most a_maxRectSize cells a side, then connects rectangles along
+	//every stretch of shared border. Cells map to world space as GraphGenerator does: cell (x, y) spans x * a_cellWidth
+	//and z downward from the top of the map.
+	void BuildFromMask(const GridMask& a_mask, float a_cellWidth, float a_cellHeight, int a_maxRectSize = 16);
+
+	//Polygon containing the point, or invalid_node_index
+	int FindPolygon(const DirectX::XMFLOAT3& a_position) const;
+
+	//Writes the string-pulled waypoints from a_start to a_goal (both included). Returns false if either point is off
+	//the mesh or there is no path.
+	bool FindPath(const DirectX::XMFLOAT3& a_start, const DirectX::XMFLOAT3& a_goal, std::vector<DirectX::XMFLOAT3>& a_waypoints);
+
+	int NumPolygons() const { return (int)m_Polygons.size(); }
+	int GetLastNodesSearched() const { return m_LastNodesSearched; }
+	const GraphType& GetGraph() const { return m_Graph; }
+private:
+	NavMesh(const NavMesh&);
+	NavMesh& operator=(const NavMesh&);
+
+	struct Polygon
+	{
+		int firstVertex; //Into m_PolygonVertices
+		int numVertices;
+	};
+
+	struct Portal
+	{
+		int neighbour;
+		DirectX::XMFLOAT3 a;
+		DirectX::XMFLOAT3 b;
+	};
+
+	void Clear();
+	int AddPolygon(const int* a_vertexIndices, int a_numVertices);
+	void AddPortal(int a_from, int a_to, const DirectX::XMFLOAT3& a_a, const DirectX::XMFLOAT3& a_b);
+	bool ContainsPoint(int a_polygon, float a_x, float a_z) const;
+	const Portal* FindPortal(int a_from, int a_to) const;
+	void StringPull(std::vector<DirectX::XMFLOAT3>& a_waypoints) const;
+
+	std::vector<DirectX::XMFLOAT3> m_Vertices;
+	std::vector<int> m_PolygonVertices;
+	std::vector<Polygon> m_Polygons;
+	std::vector<std::vector<Portal> > m_Portals; //Per polygon
+	GraphType m_Graph;
+
+	//Cell lookup for meshes built from a mask
+	std::vector<int> m_PolygonOfCell;
+	int m_MaskWidth;
+	int m_MaskHeight;
+	float m_CellWidth;
+	float m_CellHeight;
+
+	std::vector<int> m_PolygonPath; //Scratch
+	std::vector<DirectX::XMFLOAT3> m_PortalLeft; //Scratch: funnel portals, left and right as seen walking the corridor
+	std::vector<DirectX::XMFLOAT3> m_PortalRight;
+	int m_LastNodesSearched;
+};
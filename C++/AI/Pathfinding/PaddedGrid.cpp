@@ -0,0 +1,40 @@
+#include <AI/Pathfinding/PaddedGrid.h>
+
+PaddedGrid::PaddedGrid(const GridMask& a_mask)
+	: m_Width(a_mask.Width())
+	, m_Height(a_mask.Height())
+	, m_PaddedWidth(a_mask.Width() + 2)
+{
+	Update(a_mask);
+}
+
+void PaddedGrid::Update(const GridMask& a_mask)
+{
+	assert(a_mask.Width() == m_Width && a_mask.Height() == m_Height && "<PaddedGrid::Update>: mask size changed");
+
+	m_Open.assign(m_PaddedWidth * (m_Height + 2), 0);
+
+	if (a_mask.HasCosts())
+	{
+		m_CostMultiplier.assign(m_Open.size(), 1.f);
+	}
+	else
+	{
+		m_CostMultiplier.clear();
+	}
+
+	for (int y = 0; y < m_Height; ++y)
+	{
+		for (int x = 0; x < m_Width; ++x)
+		{
+			const int padded = (y + 1) * m_PaddedWidth + x + 1;
+
+			m_Open[padded] = a_mask.IsWalkable(x, y) ? 1 : 0;
+
+			if (a_mask.HasCosts())
+			{
+				m_CostMultiplier[padded] = a_mask.GetCostMultiplier(x, y);
+			}
+		}
+	}
+}
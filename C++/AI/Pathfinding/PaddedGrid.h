@@ -0,0 +1,39 @@
+#pragma once
+
+#include <AI/Pathfinding/GridMask.h>
+
+#include <cassert>
+#include <vector>
+
+//Byte-per-cell copy of a GridMask surrounded by a one cell blocked border, so grid kernels can step to any neighbour
+//of a walkable cell without bounds checks. Padded index p = (y + 1) * PaddedWidth() + (x + 1).
+class PaddedGrid
+{
+public:
+	explicit PaddedGrid(const GridMask& a_mask);
+
+	//Refreshes the walkable flags and cost multipliers from a mask of the same size
+	void Update(const GridMask& a_mask);
+
+	int Width() const { return m_Width; }
+	int Height() const { return m_Height; }
+	int PaddedWidth() const { return m_PaddedWidth; }
+	int NumPaddedCells() const { return (int)m_Open.size(); }
+
+	int ToPadded(int a_cell) const { return (a_cell / m_Width + 1) * m_PaddedWidth + a_cell % m_Width + 1; }
+	int FromPadded(int a_padded) const { return (a_padded / m_PaddedWidth - 1) * m_Width + a_padded % m_PaddedWidth - 1; }
+	int PaddedX(int a_padded) const { return a_padded % m_PaddedWidth; }
+	int PaddedY(int a_padded) const { return a_padded / m_PaddedWidth; }
+
+	bool IsOpen(int a_padded) const { return m_Open[a_padded] != 0; }
+
+	//Terrain multipliers, only present if the mask had a cost layer
+	bool HasCosts() const { return !m_CostMultiplier.empty(); }
+	float CostMultiplier(int a_padded) const { assert(HasCosts()); return m_CostMultiplier[a_padded]; }
+private:
+	int m_Width;
+	int m_Height;
+	int m_PaddedWidth;
+	std::vector<unsigned char> m_Open;
+	std::vector<float> m_CostMultiplier;
+};
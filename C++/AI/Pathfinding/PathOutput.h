@@ -0,0 +1,64 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <AI/Pathfinding/NodeTypeEnumerations.h>
+
+#include <algorithm>
+#include <vector>
+
+//Helpers shared by the searches' allocation-free path getters. a_parentOf(node) returns the node's parent on the path,
+//or invalid_node_index once the start is reached. Paths always come out start first.
+
+//Clears a_path (keeping its capacity), walks back from a_target and reverses in place
+template <class parent_fn>
+void WritePath(int a_target, parent_fn a_parentOf, std::vector<int>& a_path)
+{
+	a_path.clear();
+
+	for (int node = a_target; node != invalid_node_index; node = a_parentOf(node))
+	{
+		a_path.push_back(node);
+	}
+
+	std::reverse(a_path.begin(), a_path.end());
+}
+
+//Returns the number of nodes on the path. The path is written back to front into a_buffer only if it fits, so a
+//caller with too small a buffer can grow it to the returned size and ask again.
+template <class parent_fn>
+int WritePath(int a_target, parent_fn a_parentOf, int* a_buffer, int a_capacity)
+{
+	int length = 0;
+
+	for (int node = a_target; node != invalid_node_index; node = a_parentOf(node))
+	{
+		++length;
+	}
+
+	if (length <= a_capacity)
+	{
+		int slot = length;
+
+		for (int node = a_target; node != invalid_node_index; node = a_parentOf(node))
+		{
+			a_buffer[--slot] = node;
+		}
+	}
+
+	return length;
+}
+
+//World positions of the path's nodes, start first
+template <class graph_type, class parent_fn>
+void WritePathPositions(const graph_type& a_graph, int a_target, parent_fn a_parentOf, std::vector<DirectX::XMFLOAT3>& a_positions)
+{
+	a_positions.clear();
+
+	for (int node = a_target; node != invalid_node_index; node = a_parentOf(node))
+	{
+		a_positions.push_back(a_graph.GetNode(node).GetPositionF3());
+	}
+
+	std::reverse(a_positions.begin(), a_positions.end());
+}
@@ -361,6 +361,11 @@ public:
 
   bool empty()const{return (m_iSize==0);}
 
+  int size()const{return m_iSize;}
+
+  //the index with the lowest key, without removing it
+  int peek()const{return m_Heap[1];}
+
   //to insert an item into the queue it gets added to the end of the heap
   //and then the heap is reordered from the bottom up.
   void insert(const int idx)
@@ -0,0 +1,84 @@
+#include <AI/Pathfinding/SearchStats.h>
+
+void SearchStatsLog::BeginFrame(int a_frame)
+{
+	if (m_FrameOpen)
+	{
+		EndFrame();
+	}
+
+	m_CurrentFrame = a_frame;
+	m_Current.frame = a_frame;
+	m_Current.numSearches = 0;
+	m_Current.totals.Reset();
+	m_FrameOpen = true;
+}
+
+void SearchStatsLog::Add(const SearchStats& a_stats)
+{
+	if (!m_FrameOpen)
+	{
+		BeginFrame(m_CurrentFrame);
+	}
+
+	SearchStats& totals = m_Current.totals;
+
+	++m_Current.numSearches;
+	totals.nodesExpanded += a_stats.nodesExpanded;
+	totals.edgesRelaxed += a_stats.edgesRelaxed;
+	totals.heapPushes += a_stats.heapPushes;
+	totals.decreaseKeys += a_stats.decreaseKeys;
+	totals.wallTimeNs += a_stats.wallTimeNs;
+
+	if (a_stats.peakOpenListSize > totals.peakOpenListSize)
+	{
+		totals.peakOpenListSize = a_stats.peakOpenListSize;
+	}
+}
+
+void SearchStatsLog::EndFrame()
+{
+	if (!m_FrameOpen)
+	{
+		return;
+	}
+
+	m_Frames.push_back(m_Current);
+	m_FrameOpen = false;
+	++m_CurrentFrame;
+}
+
+void SearchStatsLog::ExportJson(std::ostream& a_os) const
+{
+	a_os << "[\n";
+
+	for (size_t i = 0; i < m_Frames.size(); ++i)
+	{
+		const FrameStats& f = m_Frames[i];
+
+		a_os << "  { \"frame\": " << f.frame
+			<< ", \"searches\": " << f.numSearches
+			<< ", \"nodes_expanded\": " << f.totals.nodesExpanded
+			<< ", \"edges_relaxed\": " << f.totals.edgesRelaxed
+			<< ", \"heap_pushes\": " << f.totals.heapPushes
+			<< ", \"decrease_keys\": " << f.totals.decreaseKeys
+			<< ", \"peak_open_list\": " << f.totals.peakOpenListSize
+			<< ", \"wall_time_ns\": " << f.totals.wallTimeNs << " }"
+			<< (i + 1 < m_Frames.size() ? ",\n" : "\n");
+	}
+
+	a_os << "]\n";
+}
+
+void SearchStatsLog::ExportCsv(std::ostream& a_os) const
+{
+	a_os << "frame,searches,nodes_expanded,edges_relaxed,heap_pushes,decrease_keys,peak_open_list,wall_time_ns\n";
+
+	for (size_t i = 0; i < m_Frames.size(); ++i)
+	{
+		const FrameStats& f = m_Frames[i];
+
+		a_os << f.frame << ',' << f.numSearches << ',' << f.totals.nodesExpanded << ',' << f.totals.edgesRelaxed << ','
+			<< f.totals.heapPushes << ',' << f.totals.decreaseKeys << ',' << f.totals.peakOpenListSize << ',' << f.totals.wallTimeNs << '\n';
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <ostream>
+#include <vector>
+
+//Statistics sinks for the graph search templates, selected through their stats_type template parameter.
+//
+//SearchStats_None is the default: every hook is an empty inline function, so a search instantiated with it
+//does no counting, no timing and no I/O. SearchStats records counters and steady-clock wall time, and
+//SearchStatsLog aggregates them per frame for export.
+
+struct SearchStats_None
+{
+	void BeginSearch() {}
+	void EndSearch() {}
+	void OnNodeExpanded() {}
+	void OnEdgeRelaxed() {}
+	void OnHeapPush(int) {}
+	void OnDecreaseKey() {}
+};
+
+struct SearchStats
+{
+	int nodesExpanded; //Nodes taken off the open list
+	int edgesRelaxed; //Edges examined from expanded nodes
+	int heapPushes; //Nodes added to the open list
+	int decreaseKeys; //Open list entries whose cost was lowered
+	int peakOpenListSize;
+	long long wallTimeNs;
+
+	SearchStats() { Reset(); }
+
+	void Reset()
+	{
+		nodesExpanded = 0;
+		edgesRelaxed = 0;
+		heapPushes = 0;
+		decreaseKeys = 0;
+		peakOpenListSize = 0;
+		wallTimeNs = 0;
+	}
+
+	void BeginSearch() { m_StartTime = std::chrono::steady_clock::now(); }
+	void EndSearch() { wallTimeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_StartTime).count(); }
+	void OnNodeExpanded() { ++nodesExpanded; }
+	void OnEdgeRelaxed() { ++edgesRelaxed; }
+	void OnHeapPush(int a_openListSize) { ++heapPushes; if (a_openListSize > peakOpenListSize) peakOpenListSize = a_openListSize; }
+	void OnDecreaseKey() { ++decreaseKeys; }
+
+private:
+	std::chrono::steady_clock::time_point m_StartTime;
+};
+
+//Sums the stats of every search run during a frame and keeps a history of frame totals
+class SearchStatsLog
+{
+public:
+	struct FrameStats
+	{
+		int frame;
+		int numSearches;
+		SearchStats totals; //peakOpenListSize is the largest of any single search in the frame
+	};
+
+	SearchStatsLog() : m_CurrentFrame(0), m_FrameOpen(false) {}
+
+	void BeginFrame(int a_frame);
+	void Add(const SearchStats& a_stats);
+	void EndFrame();
+
+	const std::vector<FrameStats>& GetFrames() const { return m_Frames; }
+	void Clear() { m_Frames.clear(); m_FrameOpen = false; }
+
+	void ExportJson(std::ostream& a_os) const;
+	void ExportCsv(std::ostream& a_os) const;
+private:
+	std::vector<FrameStats> m_Frames;
+	FrameStats m_Current;
+	int m_CurrentFrame;
+	bool m_FrameOpen;
+};
@@ -0,0 +1,506 @@
+#include <AI/Pathfinding/SectorFlowField.h>
+
+#include <AI/Pathfinding/Graph_SearchDijkstraMultiSource.h>
+#include <AI/Pathfinding/Grid_SearchAStar.h>
+#include <AI/Pathfinding/PriorityQueue.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+
+namespace
+{
+	typedef GridConnectivity8 Connectivity;
+
+	//Neighbour slot pointing back the other way
+	const unsigned char k_Opposite[8] = { 1, 0, 3, 2, 7, 6, 5, 4 };
+}
+
+SectorFlowField::SectorFlowField(const GridMask& a_mask, int a_sectorSize, int a_maxRoutes)
+	: m_Mask(a_mask)
+	, m_SectorSize(a_sectorSize)
+	, m_SectorsX(0)
+	, m_SectorsY(0)
+	, m_Graph(false)
+	, m_MaxRoutes(a_maxRoutes)
+	, m_NumCachedFields(0)
+	, m_NumSectorsTouched(0)
+	, m_Cost(a_sectorSize * a_sectorSize)
+{
+	assert(a_sectorSize > 0 && a_sectorSize * a_sectorSize < k_NoRegion && "<SectorFlowField>: sector too large for 16 bit region ids");
+	assert(a_maxRoutes > 0 && "<SectorFlowField>: needs room for a route");
+
+	Build();
+}
+
+void SectorFlowField::Build()
+{
+	m_SectorsX = (m_Mask.Width() + m_SectorSize - 1) / m_SectorSize;
+	m_SectorsY = (m_Mask.Height() + m_SectorSize - 1) / m_SectorSize;
+
+	BuildRegions();
+	BuildPortals();
+	ClearCache();
+}
+
+void SectorFlowField::ClearCache()
+{
+	m_Routes.clear();
+	m_RouteUse.clear();
+	m_ExitFields.assign(m_Graph.NumNodes(), std::vector<unsigned char>());
+	m_SectorTouched.assign(NumSectors(), 0);
+	m_NumCachedFields = 0;
+	m_NumSectorsTouched = 0;
+}
+
+int SectorFlowField::RegionOfCell(int a_cell) const
+{
+	const int x = a_cell % m_Mask.Width();
+	const int y = a_cell / m_Mask.Width();
+	const uint16_t local = m_LocalRegionOfCell[a_cell];
+
+	return local == k_NoRegion ? -1 : m_FirstRegionOfSector[SectorOf(x, y)] + local;
+}
+
+int SectorFlowField::NodeCell(int a_node) const
+{
+	const Portal& portal = m_Portals[m_PortalOfNode[a_node]];
+
+	return portal.firstCell + (portal.length / 2) * portal.along + (a_node & 1) * portal.across;
+}
+
+//Flood fills each sector's walkable cells, 4-connected. Without corner cutting a diagonal step needs both cells beside
+//it open, so this is the same grouping the 8-connected moves give.
+void SectorFlowField::BuildRegions()
+{
+	const int width = m_Mask.Width();
+
+	m_LocalRegionOfCell.assign(m_Mask.NumCells(), k_NoRegion);
+	m_FirstRegionOfSector.assign(NumSectors() + 1, 0);
+
+	std::vector<int> stack;
+	int numRegions = 0;
+
+	for (int sy = 0; sy < m_SectorsY; ++sy)
+	{
+		for (int sx = 0; sx < m_SectorsX; ++sx)
+		{
+			const int x0 = sx * m_SectorSize;
+			const int y0 = sy * m_SectorSize;
+			const int x1 = std::min(x0 + m_SectorSize, width);
+			const int y1 = std::min(y0 + m_SectorSize, m_Mask.Height());
+			uint16_t local = 0;
+
+			m_FirstRegionOfSector[SectorOf(x0, y0)] = numRegions;
+
+			for (int y = y0; y < y1; ++y)
+			{
+				for (int x = x0; x < x1; ++x)
+				{
+					if (!m_Mask.IsWalkable(x, y) || m_LocalRegionOfCell[m_Mask.CellIndex(x, y)] != k_NoRegion)
+					{
+						continue;
+					}
+
+					m_LocalRegionOfCell[m_Mask.CellIndex(x, y)] = local;
+					stack.push_back(m_Mask.CellIndex(x, y));
+
+					while (!stack.empty())
+					{
+						const int cell = stack.back();
+						stack.pop_back();
+
+						for (int i = 0; i < 4; ++i)
+						{
+							const int nx = cell % width + Connectivity::k_OffsetX[i];
+							const int ny = cell / width + Connectivity::k_OffsetY[i];
+
+							if (nx >= x0 && nx < x1 && ny >= y0 && ny < y1 && m_Mask.IsWalkable(nx, ny) &&
+								m_LocalRegionOfCell[m_Mask.CellIndex(nx, ny)] == k_NoRegion)
+							{
+								m_LocalRegionOfCell[m_Mask.CellIndex(nx, ny)] = local;
+								stack.push_back(m_Mask.CellIndex(nx, ny));
+							}
+						}
+					}
+
+					++local;
+				}
+			}
+
+			numRegions += local;
+		}
+	}
+
+	m_FirstRegionOfSector[NumSectors()] = numRegions;
+}
+
+void SectorFlowField::AddPortal(int a_firstCell, int a_length, int a_along, int a_across)
+{
+	Portal portal;
+	portal.firstCell = a_firstCell;
+	portal.length = a_length;
+	portal.along = a_along;
+	portal.across = a_across;
+
+	const int width = m_Mask.Width();
+
+	for (int side = 0; side < 2; ++side)
+	{
+		const int cell = a_firstCell + (a_length / 2) * a_along + side * a_across;
+
+		portal.node[side] = m_Graph.AddNode(NavNode(m_Graph.GetNextFreeNodeIndex(), DirectX::XMFLOAT3((float)(cell % width), 0.f, (float)(cell / width))));
+		m_PortalOfNode.push_back((int)m_Portals.size());
+		m_NodesOfSector[SectorOf(cell % width, cell / width)].push_back(portal.node[side]);
+	}
+
+	//A cardinal step across, at the terrain cost of the middle pair of cells
+	const int middle = a_firstCell + (a_length / 2) * a_along;
+	const float cost = 0.5f * (m_Mask.GetCostMultiplier(middle % width, middle / width) + m_Mask.GetCostMultiplier((middle + a_across) % width, (middle + a_across) / width));
+
+	m_Graph.AddEdge(NavEdge(portal.node[0], portal.node[1], cost));
+	m_Portals.push_back(portal);
+}
+
+void SectorFlowField::BuildPortals()
+{
+	const int width = m_Mask.Width();
+	const int height = m_Mask.Height();
+
+	m_Portals.clear();
+	m_PortalOfNode.clear();
+	m_NodesOfSector.assign(NumSectors(), std::vector<int>());
+	m_Graph.Clear();
+	m_Graph.SetDigraph(false);
+
+	//Runs of open pairs along each vertical border (x | x + 1), then each horizontal one (y / y + 1), cut at sector
+	//corners so each run joins exactly two sectors
+	for (int x = m_SectorSize - 1; x + 1 < width; x += m_SectorSize)
+	{
+		for (int y0 = 0; y0 < height; y0 += m_SectorSize)
+		{
+			const int y1 = std::min(y0 + m_SectorSize, height);
+			int runStart = -1;
+
+			for (int y = y0; y <= y1; ++y)
+			{
+				const bool open = y < y1 && m_Mask.IsWalkable(x, y) && m_Mask.IsWalkable(x + 1, y);
+
+				if (open && runStart < 0)
+				{
+					runStart = y;
+				}
+				else if (!open && runStart >= 0)
+				{
+					AddPortal(m_Mask.CellIndex(x, runStart), y - runStart, width, 1);
+					runStart = -1;
+				}
+			}
+		}
+	}
+
+	for (int y = m_SectorSize - 1; y + 1 < height; y += m_SectorSize)
+	{
+		for (int x0 = 0; x0 < width; x0 += m_SectorSize)
+		{
+			const int x1 = std::min(x0 + m_SectorSize, width);
+			int runStart = -1;
+
+			for (int x = x0; x <= x1; ++x)
+			{
+				const bool open = x < x1 && m_Mask.IsWalkable(x, y) && m_Mask.IsWalkable(x, y + 1);
+
+				if (open && runStart < 0)
+				{
+					runStart = x;
+				}
+				else if (!open && runStart >= 0)
+				{
+					AddPortal(m_Mask.CellIndex(runStart, y), x - runStart, 1, width);
+					runStart = -1;
+				}
+			}
+		}
+	}
+
+	//Join the nodes sharing a region by their cost through the sector
+	std::vector<Seed> seeds(1);
+	std::vector<unsigned char> field;
+
+	for (int sector = 0; sector < NumSectors(); ++sector)
+	{
+		const std::vector<int>& nodes = m_NodesOfSector[sector];
+
+		for (size_t a = 0; a + 1 < nodes.size(); ++a)
+		{
+			const int cellA = NodeCell(nodes[a]);
+
+			seeds[0].cell = cellA;
+			seeds[0].cost = 0.f;
+			seeds[0].direction = k_AtGoal;
+			Integrate(sector, seeds, field);
+
+			for (size_t b = a + 1; b < nodes.size(); ++b)
+			{
+				const int cellB = NodeCell(nodes[b]);
+
+				if (RegionOfCell(cellB) == RegionOfCell(cellA))
+				{
+					m_Graph.AddEdge(NavEdge(nodes[a], nodes[b], m_Cost[LocalIndex(cellB % width, cellB / width)]));
+				}
+			}
+		}
+	}
+}
+
+void SectorFlowField::Integrate(int a_sector, const std::vector<Seed>& a_seeds, std::vector<unsigned char>& a_field)
+{
+	const int width = m_Mask.Width();
+	const int x0 = (a_sector % m_SectorsX) * m_SectorSize;
+	const int y0 = (a_sector / m_SectorsX) * m_SectorSize;
+	const int x1 = std::min(x0 + m_SectorSize, width);
+	const int y1 = std::min(y0 + m_SectorSize, m_Mask.Height());
+
+	a_field.assign(m_SectorSize * m_SectorSize, k_Unreached);
+	std::fill(m_Cost.begin(), m_Cost.end(), FLT_MAX);
+
+	IndexedPriorityQLow<float> priorityQueue(m_Cost, (int)m_Cost.size());
+
+	for (size_t s = 0; s < a_seeds.size(); ++s)
+	{
+		const int local = LocalIndex(a_seeds[s].cell % width, a_seeds[s].cell / width);
+
+		if (a_seeds[s].cost < m_Cost[local])
+		{
+			const bool queued = m_Cost[local] < FLT_MAX;
+
+			m_Cost[local] = a_seeds[s].cost;
+			a_field[local] = a_seeds[s].direction;
+
+			if (queued)
+			{
+				priorityQueue.ChangePriority(local);
+			}
+			else
+			{
+				priorityQueue.insert(local);
+			}
+		}
+	}
+
+	//Unreached cells keep FLT_MAX, so a cell is settled once popped and open while its cost is below FLT_MAX
+	std::vector<char> settled(m_Cost.size(), 0);
+
+	while (!priorityQueue.empty())
+	{
+		const int local = priorityQueue.Pop();
+		const int x = x0 + local % m_SectorSize;
+		const int y = y0 + local / m_SectorSize;
+		const float multiplier = m_Mask.GetCostMultiplier(x, y);
+
+		settled[local] = 1;
+
+		for (int i = 0; i < Connectivity::NumNeighbours; ++i)
+		{
+			const int nx = x + Connectivity::k_OffsetX[i];
+			const int ny = y + Connectivity::k_OffsetY[i];
+
+			if (nx < x0 || nx >= x1 || ny < y0 || ny >= y1 || !m_Mask.IsWalkable(nx, ny))
+			{
+				continue;
+			}
+
+			if (Connectivity::IsDiagonal(i) && !Connectivity::DiagonalAllowed(m_Mask.IsWalkable(nx, y), m_Mask.IsWalkable(x, ny)))
+			{
+				continue;
+			}
+
+			const int neighbour = LocalIndex(nx, ny);
+
+			if (settled[neighbour])
+			{
+				continue;
+			}
+
+			const float cost = m_Cost[local] + GridCost_Octile::StepLength(i) * 0.5f * (multiplier + m_Mask.GetCostMultiplier(nx, ny));
+
+			if (cost < m_Cost[neighbour])
+			{
+				const bool queued = m_Cost[neighbour] < FLT_MAX;
+
+				m_Cost[neighbour] = cost;
+				a_field[neighbour] = k_Opposite[i];
+
+				if (queued)
+				{
+					priorityQueue.ChangePriority(neighbour);
+				}
+				else
+				{
+					priorityQueue.insert(neighbour);
+				}
+			}
+		}
+	}
+}
+
+void SectorFlowField::Touch(int a_sector)
+{
+	++m_NumCachedFields;
+
+	if (!m_SectorTouched[a_sector])
+	{
+		m_SectorTouched[a_sector] = 1;
+		++m_NumSectorsTouched;
+	}
+}
+
+const SectorFlowField::Route& SectorFlowField::GetRoute(int a_goalCell)
+{
+	std::unordered_map<int, Route>::iterator found = m_Routes.find(a_goalCell);
+
+	if (found != m_Routes.end())
+	{
+		m_RouteUse.splice(m_RouteUse.begin(), m_RouteUse, found->second.use);
+		return found->second;
+	}
+
+	//Only the goal field goes with the route; the exit fields can be reached from other routes
+	if ((int)m_Routes.size() >= m_MaxRoutes)
+	{
+		m_Routes.erase(m_RouteUse.back());
+		m_RouteUse.pop_back();
+		--m_NumCachedFields;
+	}
+
+	const int width = m_Mask.Width();
+	const int goalSector = SectorOf(a_goalCell % width, a_goalCell / width);
+
+	Route& route = m_Routes[a_goalCell];
+	m_RouteUse.push_front(a_goalCell);
+	route.use = m_RouteUse.begin();
+	route.goalRegion = RegionOfCell(a_goalCell);
+	route.exitOfRegion.assign(m_FirstRegionOfSector.back(), invalid_node_index);
+
+	std::vector<Seed> seeds(1);
+	seeds[0].cell = a_goalCell;
+	seeds[0].cost = 0.f;
+	seeds[0].direction = k_AtGoal;
+	Integrate(goalSector, seeds, route.goalField);
+	Touch(goalSector);
+
+	//The portal graph search starts from the goal region's nodes at their cost through the goal sector
+	std::vector<int> sources;
+	std::vector<float> sourceCosts;
+	const std::vector<int>& goalNodes = m_NodesOfSector[goalSector];
+
+	for (size_t n = 0; n < goalNodes.size(); ++n)
+	{
+		const int cell = NodeCell(goalNodes[n]);
+
+		if (RegionOfCell(cell) == route.goalRegion)
+		{
+			sources.push_back(goalNodes[n]);
+			sourceCosts.push_back(m_Cost[LocalIndex(cell % width, cell / width)]);
+		}
+	}
+
+	if (sources.empty())
+	{
+		return route;
+	}
+
+	Graph_SearchDijkstraMultiSource<GraphType> portalSearch(m_Graph, sources, &sourceCosts);
+
+	//Each region leaves through its nearest node to the goal whose best path crosses its own portal. Nodes sharing a
+	//cell are joined at no cost, so the nearest node overall can tie with one that doesn't cross; among crossing nodes
+	//the cost falls strictly from one region's exit to the next and agents can't go round in circles.
+	std::vector<float> bestCost(route.exitOfRegion.size(), FLT_MAX);
+
+	for (int node = 0; node < m_Graph.NumNodes(); ++node)
+	{
+		const NavEdge* towardGoal = portalSearch.GetAllPaths()[node];
+
+		if (!towardGoal || towardGoal->From() != (node ^ 1))
+		{
+			continue;
+		}
+
+		const int region = RegionOfCell(NodeCell(node));
+
+		if (region != route.goalRegion && portalSearch.GetCostToNode(node) < bestCost[region])
+		{
+			bestCost[region] = portalSearch.GetCostToNode(node);
+			route.exitOfRegion[region] = node;
+		}
+	}
+
+	return route;
+}
+
+//Leads every cell of the node's sector to the node's side of its portal, and from there across it
+const std::vector<unsigned char>& SectorFlowField::GetExitField(int a_node)
+{
+	std::vector<unsigned char>& field = m_ExitFields[a_node];
+
+	if (!field.empty())
+	{
+		return field;
+	}
+
+	const Portal& portal = m_Portals[m_PortalOfNode[a_node]];
+	const int side = a_node & 1;
+	const int firstCell = portal.firstCell + side * portal.across;
+	const int width = m_Mask.Width();
+
+	//Neighbour slot of the step across: +x, -x, +y, -y
+	const unsigned char crossing = (unsigned char)((portal.across == 1 ? 0 : 2) + side);
+
+	std::vector<Seed> seeds(portal.length);
+
+	for (int i = 0; i < portal.length; ++i)
+	{
+		seeds[i].cell = firstCell + i * portal.along;
+		seeds[i].cost = 0.f;
+		seeds[i].direction = crossing;
+	}
+
+	const int sector = SectorOf(firstCell % width, firstCell / width);
+
+	Integrate(sector, seeds, field);
+	Touch(sector);
+
+	return field;
+}
+
+int SectorFlowField::GetNextCell(int a_cell, int a_goalCell)
+{
+	const int width = m_Mask.Width();
+	const int x = a_cell % width;
+	const int y = a_cell / width;
+
+	if (!m_Mask.IsWalkable(x, y) || !m_Mask.IsWalkable(a_goalCell % width, a_goalCell / width))
+	{
+		return invalid_node_index;
+	}
+
+	const Route& route = GetRoute(a_goalCell);
+	const int region = RegionOfCell(a_cell);
+	unsigned char step = k_Unreached;
+
+	if (region == route.goalRegion)
+	{
+		step = route.goalField[LocalIndex(x, y)];
+	}
+	else if (route.exitOfRegion[region] != invalid_node_index)
+	{
+		step = GetExitField(route.exitOfRegion[region])[LocalIndex(x, y)];
+	}
+
+	if (step >= Connectivity::NumNeighbours)
+	{
+		return invalid_node_index;
+	}
+
+	return m_Mask.CellIndex(x + Connectivity::k_OffsetX[step], y + Connectivity::k_OffsetY[step]);
+}
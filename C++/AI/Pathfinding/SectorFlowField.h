@@ -0,0 +1,128 @@
+#pragma once
+
+#include <AI/Pathfinding/GridMask.h>
+#include <AI/Pathfinding/NavGraphTypes.h>
+#include <AI/Pathfinding/SparseGraph.h>
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+//Hierarchical flow fields for large grids. The map is cut into square sectors and each sector into regions (groups of
+//walkable cells connected inside the sector). Every stretch of border where two sectors are open on both sides is a
+//portal, with one node on each side in a small portal graph: nodes of the same region are joined by their in-sector
+//path cost, the two sides of a portal by the step across.
+//
+//A goal gets one Dijkstra over the portal graph, which picks an exit portal for every region, and an integration field
+//over the goal's own sector. Every other field is per (sector, exit portal) and leads out through that portal, so it is
+//shared by every goal routed the same way. Fields are generated the first time an agent asks for a cell in them, so
+//a crowd only pays for the sectors it actually walks through. At most a_maxRoutes goals are kept; asking for one more
+//drops the least recently used goal's route (its exit fields are shared and stay).
+//
+//Moves are 8-connected without corner cutting (GridConnectivity8) with octile step lengths scaled by the terrain cost
+//of the two cells, as GridCost_Terrain. Paths are optimal inside a sector, but each region commits to one exit wherever
+//an agent stands in it, so long paths on cluttered maps come out around 10-30% over the optimal cost.
+class SectorFlowField
+{
+public:
+	typedef SparseGraph<NavNode, NavEdge> GraphType;
+
+	//Sectors hold at most 0xFFFE cells (a_sectorSize up to 255)
+	explicit SectorFlowField(const GridMask& a_mask, int a_sectorSize = 32, int a_maxRoutes = 256);
+
+	//Rebuilds regions and portals and drops every cached field, e.g. after the mask has changed
+	void Build();
+
+	//Cell (y * width + x) to step to from a_cell on the way to a_goalCell; invalid_node_index at the goal or if the goal
+	//can't be reached
+	int GetNextCell(int a_cell, int a_goalCell);
+
+	void ClearCache();
+
+	int SectorSize() const { return m_SectorSize; }
+	int NumSectors() const { return m_SectorsX * m_SectorsY; }
+	int NumPortals() const { return (int)m_Portals.size(); }
+	const GraphType& GetPortalGraph() const { return m_Graph; }
+
+	int NumCachedRoutes() const { return (int)m_Routes.size(); }
+	int NumCachedFields() const { return m_NumCachedFields; }
+	int NumSectorsTouched() const { return m_NumSectorsTouched; } //Sectors with at least one field generated
+private:
+	SectorFlowField(const SectorFlowField&);
+	SectorFlowField& operator=(const SectorFlowField&);
+
+	enum
+	{
+		k_NoRegion = 0xFFFF,
+
+		//Field entries: the neighbour slot to step to, or one of these
+		k_AtGoal = 8,
+		k_Unreached = 0xFF
+	};
+
+	struct Portal
+	{
+		int firstCell; //On side 0
+		int length;
+		int along; //Cell offset from one cell of the run to the next
+		int across; //Cell offset from side 0 to side 1 (1 or width)
+		int node[2]; //Portal graph node of each side
+	};
+
+	struct Seed
+	{
+		int cell;
+		float cost;
+		unsigned char direction;
+	};
+
+	//Per goal: the exit each region takes and the field over the goal's sector
+	struct Route
+	{
+		int goalRegion;
+		std::vector<int> exitOfRegion; //Portal graph node, invalid_node_index if the goal is unreachable
+		std::vector<unsigned char> goalField;
+		std::list<int>::iterator use; //Into m_RouteUse
+	};
+
+	int SectorOf(int a_x, int a_y) const { return (a_y / m_SectorSize) * m_SectorsX + a_x / m_SectorSize; }
+	int LocalIndex(int a_x, int a_y) const { return (a_y % m_SectorSize) * m_SectorSize + a_x % m_SectorSize; }
+	int RegionOfCell(int a_cell) const;
+	int NodeCell(int a_node) const; //Middle of the portal run on the node's side
+
+	void BuildRegions();
+	void AddPortal(int a_firstCell, int a_length, int a_along, int a_across);
+	void BuildPortals();
+
+	//Dijkstra over one sector out from the seeds, leaving the cost of every cell in m_Cost and the step towards the
+	//seeds in a_field (one entry per local cell)
+	void Integrate(int a_sector, const std::vector<Seed>& a_seeds, std::vector<unsigned char>& a_field);
+	void Touch(int a_sector);
+
+	const Route& GetRoute(int a_goalCell);
+	const std::vector<unsigned char>& GetExitField(int a_node);
+
+	const GridMask& m_Mask;
+	int m_SectorSize;
+	int m_SectorsX;
+	int m_SectorsY;
+
+	std::vector<uint16_t> m_LocalRegionOfCell; //k_NoRegion for blocked cells
+	std::vector<int> m_FirstRegionOfSector; //Global region = first of its sector + local region; one extra at the end
+
+	std::vector<Portal> m_Portals;
+	std::vector<int> m_PortalOfNode; //Node 2p is side 0 of portal p, node 2p + 1 side 1
+	std::vector<std::vector<int> > m_NodesOfSector;
+	GraphType m_Graph;
+
+	std::unordered_map<int, Route> m_Routes; //By goal cell
+	std::list<int> m_RouteUse; //Goal cells, most recently used first
+	int m_MaxRoutes;
+	std::vector<std::vector<unsigned char> > m_ExitFields; //By portal graph node, empty until generated
+	std::vector<char> m_SectorTouched;
+	int m_NumCachedFields;
+	int m_NumSectorsTouched;
+
+	std::vector<float> m_Cost; //Scratch: per local cell of the sector being integrated
+};
@@ -10,8 +10,11 @@
 #include <sstream>
 #include <iostream>
 #include <fstream>
+#include <algorithm>
 
 #include "NodeTypeEnumerations.h"
+#include "Bitset.h"
+#include "NavGraphTypes.h"
 #include <DirectXMath.h>
 
 template <class node_type, class edge_type>
@@ -29,7 +32,7 @@ public:
 	typedef std::vector<EdgeList>    EdgeListVector;
 
 	//ctor
-	SparseGraph(bool digraph) : m_iNextNodeIndex(0), m_bDigraph(digraph) {}
+	SparseGraph(bool digraph) : m_iNextNodeIndex(0), m_iNumActiveNodes(0), m_bDigraph(digraph) {}
 
 	//returns the node at the given index
 	const NodeType&  GetNode(int idx)const;
@@ -39,13 +42,33 @@ public:
 	const EdgeType& GetEdge(int from, int to)const;
 	EdgeType& GetEdge(int from, int to);
 
-	//retrieves the next free node index
-	int   GetNextFreeNodeIndex()const { return m_iNextNodeIndex; }
+	//retrieves the next free node index. Slots freed by RemoveNode are handed
+	//out again before the node vector is grown
+	int   GetNextFreeNodeIndex()const { return m_FreeNodeIndices.empty() ? m_iNextNodeIndex : m_FreeNodeIndices.back(); }
+
+	//the inactive slots AddNode may hand out again, the next one last. Slots
+	//added by AddPlaceholderNode are not on it
+	const std::vector<int>& GetFreeNodeIndices()const { return m_FreeNodeIndices; }
 
 	//adds a node to the graph and returns its index
 	int   AddNode(node_type node);
 	//removes a node by setting its index to invalid_node_index
 	void  RemoveNode(int node);
+	//appends an inactive slot that AddNode will not hand out again, for builders
+	//that tie node indices to something else (e.g. grid cells). It can still be
+	//brought back by an AddNode with its index
+	void  AddPlaceholderNode(node_type node);
+
+	//removes all inactive node slots, renumbering the remaining nodes and their
+	//edges so they are contiguous. Returns a table mapping each old node index
+	//to its new index (invalid_node_index for nodes that were removed)
+	std::vector<int> Compact();
+
+	//renumbers the node slots so that slot n moves to newIndexOfOld[n] (a
+	//permutation of every slot, removed ones included) and rewrites the edges
+	//to match. See GraphOrdering.h for orderings that improve memory locality.
+	//Returns the inverse table, mapping each new index to its old one
+	std::vector<int> Reorder(const std::vector<int>& newIndexOfOld);
 
 	//Use this to add an edge to the graph. The method will ensure that the
 	//edge passed as a parameter is valid before adding it to the graph. If the
@@ -61,19 +84,14 @@ public:
 	//sets the cost of an edge
 	void  SetEdgeCost(int from, int to, double cost);
 
+	//reserves storage for a graph about to be built with a known number of node slots
+	void  Reserve(int numNodes) { m_Nodes.reserve(numNodes); m_Edges.reserve(numNodes); }
+
 	//returns the number of active + inactive nodes present in the graph
 	int   NumNodes()const { return m_Nodes.size(); }
 
-	//returns the number of active nodes present in the graph (this method's
-	//performance can be improved greatly by caching the value)
-	int   NumActiveNodes()const
-	{
-		int count = 0;
-
-		for (unsigned int n = 0; n<m_Nodes.size(); ++n) if (m_Nodes[n].Index() != invalid_node_index) ++count;
-
-		return count;
-	}
+	//returns the number of active nodes present in the graph
+	int   NumActiveNodes()const { return m_iNumActiveNodes; }
 
 	//returns the total number of edges present in the graph
 	int   NumEdges()const
@@ -112,10 +130,23 @@ public:
 	bool  Load(std::ifstream& stream);
 	bool  Load(std::vector<std::string> data);
 
+	//raw binary save/load for trivially copyable node and edge types (e.g. NavNode
+	//and NavEdge). Nodes and edges are written and read as whole arrays.
+	bool  SaveBinary(std::ostream& stream)const;
+	bool  LoadBinary(std::istream& stream);
+
 	std::vector<std::string> SplitString(const std::string& string);
 
 	//clears the graph ready for new node insertions
-	void Clear() { m_iNextNodeIndex = 0; m_Nodes.clear(); m_Edges.clear(); }
+	void Clear()
+	{
+		m_iNextNodeIndex = 0;
+		m_iNumActiveNodes = 0;
+		m_Nodes.clear();
+		m_Edges.clear();
+		m_ActiveNodes.Clear();
+		m_FreeNodeIndices.clear();
+	}
 
 	void RemoveEdges()
 	{
@@ -145,6 +176,18 @@ private:
 	//the index of the next node to be added
 	int             m_iNextNodeIndex;
 
+	//one bit per node slot, set while the node is active
+	Bitset          m_ActiveNodes;
+
+	//cached count of the set bits in m_ActiveNodes
+	int             m_iNumActiveNodes;
+
+	//indices of removed node slots, reused by AddNode before growing the graph
+	std::vector<int> m_FreeNodeIndices;
+
+	//appends an inactive slot (used when loading graphs containing removed nodes)
+	void  PushInactiveNode(const node_type& node);
+
 
 	//returns true if an edge is not already present in the graph. Used
 	//when adding edges to make sure no duplicates are created.
@@ -268,17 +311,13 @@ public:
 		//if a graph node is removed, it is not removed from the 
 		//vector of nodes (because that would mean changing all the indices of 
 		//all the nodes that have a higher index). This method takes a node
-		//iterator as a parameter and assigns the next valid element to it.
+		//iterator as a parameter and assigns the next valid element to it,
+		//skipping whole words of inactive nodes at a time.
 		void GetNextValidNode(typename NodeVector::iterator& it)
 		{
-			if (curNode == G.m_Nodes.end() || it->Index() != invalid_node_index) return;
+			int next = G.m_ActiveNodes.FindNext((int)(it - G.m_Nodes.begin()));
 
-			while ((it->Index() == invalid_node_index))
-			{
-				++it;
-
-				if (curNode == G.m_Nodes.end()) break;
-			}
+			it = (next == Bitset::npos) ? G.m_Nodes.end() : G.m_Nodes.begin() + next;
 		}
 
 	public:
@@ -295,7 +334,7 @@ public:
 
 			GetNextValidNode(curNode);
 
-			return &(*curNode);
+			return end() ? NULL : &(*curNode);
 		}
 
 		node_type* next()
@@ -304,7 +343,7 @@ public:
 
 			GetNextValidNode(curNode);
 
-			return &(*curNode);
+			return end() ? NULL : &(*curNode);
 		}
 
 		bool end()
@@ -328,17 +367,13 @@ public:
 		//if a graph node is removed or switched off, it is not removed from the 
 		//vector of nodes (because that would mean changing all the indices of 
 		//all the nodes that have a higher index. This method takes a node
-		//iterator as a parameter and assigns the next valid element to it.
+		//iterator as a parameter and assigns the next valid element to it,
+		//skipping whole words of inactive nodes at a time.
 		void GetNextValidNode(typename NodeVector::const_iterator& it)
 		{
-			if (curNode == G.m_Nodes.end() || it->Index() != invalid_node_index) return;
+			int next = G.m_ActiveNodes.FindNext((int)(it - G.m_Nodes.begin()));
 
-			while ((it->Index() == invalid_node_index))
-			{
-				++it;
-
-				if (curNode == G.m_Nodes.end()) break;
-			}
+			it = (next == Bitset::npos) ? G.m_Nodes.end() : G.m_Nodes.begin() + next;
 		}
 
 	public:
@@ -355,7 +390,7 @@ public:
 
 			GetNextValidNode(curNode);
 
-			return &(*curNode);
+			return end() ? NULL : &(*curNode);
 		}
 
 		const node_type* next()
@@ -364,7 +399,7 @@ public:
 
 			GetNextValidNode(curNode);
 
-			return &(*curNode);
+			return end() ? NULL : &(*curNode);
 		}
 
 		bool end()
@@ -384,11 +419,7 @@ public:
 template <class node_type, class edge_type>
 bool SparseGraph<node_type, edge_type>::isNodePresent(int nd)const
 {
-	if ((m_Nodes[nd].Index() == invalid_node_index) || (nd >= m_Nodes.size()))
-	{
-		return false;
-	}
-	else return true;
+	return (nd >= 0) && (nd < (int)m_Nodes.size()) && m_ActiveNodes.Test(nd);
 }
 
 //--------------------------- isEdgePresent --------------------------------
@@ -561,7 +592,8 @@ void SparseGraph<node_type, edge_type>::RemoveEdge(int from, int to)
 //-------------------------- AddNode -------------------------------------
 //
 //  Given a node this method first checks to see if the node has been added
-//  previously but is now innactive. If it is, it is reactivated.
+//  previously but is now innactive. If it is, it is reactivated and its slot
+//  is taken off the free list.
 //
 //  If the node has not been added previously, it is checked to make sure its
 //  index matches the next node index before being added to the graph
@@ -573,12 +605,30 @@ int SparseGraph<node_type, edge_type>::AddNode(node_type node)
 	{
 		//make sure the client is not trying to add a node with the same ID as
 		//a currently active node
-		assert(m_Nodes[node.Index()].Index() == invalid_node_index &&
+		assert(!m_ActiveNodes.Test(node.Index()) &&
 			"<SparseGraph::AddNode>: Attempting to add a node with a duplicate ID");
 
 		m_Nodes[node.Index()] = node;
+		m_ActiveNodes.Set(node.Index());
+		++m_iNumActiveNodes;
+
+		//the slot is usually the one handed out by GetNextFreeNodeIndex, so check the back first
+		if (!m_FreeNodeIndices.empty() && m_FreeNodeIndices.back() == node.Index())
+		{
+			m_FreeNodeIndices.pop_back();
+		}
+		else
+		{
+			std::vector<int>::iterator freeSlot = std::find(m_FreeNodeIndices.begin(), m_FreeNodeIndices.end(), node.Index());
 
-		return m_iNextNodeIndex;
+			if (freeSlot != m_FreeNodeIndices.end())
+			{
+				*freeSlot = m_FreeNodeIndices.back();
+				m_FreeNodeIndices.pop_back();
+			}
+		}
+
+		return node.Index();
 	}
 
 	else
@@ -588,11 +638,170 @@ int SparseGraph<node_type, edge_type>::AddNode(node_type node)
 
 		m_Nodes.push_back(node);
 		m_Edges.push_back(EdgeList());
+		m_ActiveNodes.PushBack(true);
+		++m_iNumActiveNodes;
 
 		return m_iNextNodeIndex++;
 	}
 }
 
+//------------------------- PushInactiveNode -----------------------------
+//
+//  Appends a node slot that is already invalidated. When editing graphs it's
+//  possible to save a graph containing removed nodes, so loading must keep
+//  their slots to preserve the indices of the nodes that follow them.
+//------------------------------------------------------------------------
+template <class node_type, class edge_type>
+void SparseGraph<node_type, edge_type>::PushInactiveNode(const node_type& node)
+{
+	m_Nodes.push_back(node);
+
+	//make sure an edgelist is added for each node
+	m_Edges.push_back(EdgeList());
+
+	m_ActiveNodes.PushBack(false);
+	m_FreeNodeIndices.push_back(m_iNextNodeIndex);
+
+	++m_iNextNodeIndex;
+}
+
+//------------------------- AddPlaceholderNode ---------------------------
+//
+//  Appends an inactive slot without putting it on the free list, so that
+//  GetNextFreeNodeIndex never returns it and the indices of the nodes after
+//  it stay tied to whatever the builder numbered them by. SaveBinary and
+//  LoadBinary keep the free list, as does copying into a VersionedGraph; the
+//  text Save and Load don't, and make every inactive slot free again.
+//------------------------------------------------------------------------
+template <class node_type, class edge_type>
+void SparseGraph<node_type, edge_type>::AddPlaceholderNode(node_type node)
+{
+	node.SetIndex(invalid_node_index);
+
+	m_Nodes.push_back(node);
+	m_Edges.push_back(EdgeList());
+	m_ActiveNodes.PushBack(false);
+
+	++m_iNextNodeIndex;
+}
+
+//------------------------------- Compact --------------------------------
+//
+//  Removes the slots of inactive nodes and renumbers the active nodes (and
+//  the edges between them) so that indices are contiguous again. Any index
+//  held outside the graph must be translated through the returned table.
+//------------------------------------------------------------------------
+template <class node_type, class edge_type>
+std::vector<int> SparseGraph<node_type, edge_type>::Compact()
+{
+	std::vector<int> remap(m_Nodes.size(), invalid_node_index);
+
+	int newIndex = 0;
+
+	for (int n = m_ActiveNodes.FindFirst(); n != Bitset::npos; n = m_ActiveNodes.FindNext(n + 1))
+	{
+		remap[n] = newIndex++;
+	}
+
+	NodeVector nodes;
+	EdgeListVector edges(newIndex);
+	nodes.reserve(newIndex);
+
+	for (int n = m_ActiveNodes.FindFirst(); n != Bitset::npos; n = m_ActiveNodes.FindNext(n + 1))
+	{
+		nodes.push_back(m_Nodes[n]);
+		nodes.back().SetIndex(remap[n]);
+
+		EdgeList& edgeList = edges[remap[n]];
+		edgeList.swap(m_Edges[n]);
+
+		for (typename EdgeList::iterator curEdge = edgeList.begin(); curEdge != edgeList.end();)
+		{
+			if (remap[curEdge->To()] == invalid_node_index)
+			{
+				curEdge = edgeList.erase(curEdge); //drop any edge left pointing at a removed node
+			}
+			else
+			{
+				curEdge->SetFrom(remap[n]);
+				curEdge->SetTo(remap[curEdge->To()]);
+				++curEdge;
+			}
+		}
+	}
+
+	m_Nodes.swap(nodes);
+	m_Edges.swap(edges);
+	m_ActiveNodes = Bitset(newIndex, true);
+	m_iNumActiveNodes = newIndex;
+	m_iNextNodeIndex = newIndex;
+	m_FreeNodeIndices.clear();
+
+	return remap;
+}
+
+//------------------------------- Reorder --------------------------------
+//
+//  Moves every node slot to the index given for it, keeping removed slots
+//  removed. Edge lists move with their nodes and are renumbered, but keep
+//  their order.
+//------------------------------------------------------------------------
+template <class node_type, class edge_type>
+std::vector<int> SparseGraph<node_type, edge_type>::Reorder(const std::vector<int>& newIndexOfOld)
+{
+	assert(newIndexOfOld.size() == m_Nodes.size() && "<SparseGraph::Reorder>: the table must cover every node slot");
+
+	std::vector<int> oldIndexOfNew(m_Nodes.size(), invalid_node_index);
+
+	for (int n = 0; n < (int)m_Nodes.size(); ++n)
+	{
+		assert(newIndexOfOld[n] >= 0 && newIndexOfOld[n] < (int)m_Nodes.size() && "<SparseGraph::Reorder>: new index out of range");
+		assert(oldIndexOfNew[newIndexOfOld[n]] == invalid_node_index && "<SparseGraph::Reorder>: the table is not a permutation");
+
+		oldIndexOfNew[newIndexOfOld[n]] = n;
+	}
+
+	NodeVector nodes;
+	EdgeListVector edges(m_Nodes.size());
+	Bitset active(m_Nodes.size(), false);
+	nodes.reserve(m_Nodes.size());
+
+	for (int n = 0; n < (int)m_Nodes.size(); ++n)
+	{
+		const int oldIndex = oldIndexOfNew[n];
+
+		nodes.push_back(m_Nodes[oldIndex]);
+
+		if (!m_ActiveNodes.Test(oldIndex))
+		{
+			continue;
+		}
+
+		nodes.back().SetIndex(n);
+		active.Set(n);
+
+		EdgeList& edgeList = edges[n];
+		edgeList.swap(m_Edges[oldIndex]);
+
+		for (typename EdgeList::iterator curEdge = edgeList.begin(); curEdge != edgeList.end(); ++curEdge)
+		{
+			curEdge->SetFrom(n);
+			curEdge->SetTo(newIndexOfOld[curEdge->To()]);
+		}
+	}
+
+	for (std::vector<int>::iterator freeSlot = m_FreeNodeIndices.begin(); freeSlot != m_FreeNodeIndices.end(); ++freeSlot)
+	{
+		*freeSlot = newIndexOfOld[*freeSlot];
+	}
+
+	m_Nodes.swap(nodes);
+	m_Edges.swap(edges);
+	m_ActiveNodes = active;
+
+	return oldIndexOfNew;
+}
+
 //----------------------- CullInvalidEdges ------------------------------------
 //
 //  iterates through all the edges in the graph and removes any that point
@@ -625,10 +834,20 @@ void SparseGraph<node_type, edge_type>::RemoveNode(int node)
 {
 	assert(node < (int)m_Nodes.size() && "<SparseGraph::RemoveNode>: invalid node index");
 
+	//removing a node twice would put its slot on the free list twice
+	if (!m_ActiveNodes.Test(node))
+	{
+		return;
+	}
 
 	//set this node's index to invalid_node_index
 	m_Nodes[node].SetIndex(invalid_node_index);
 
+	//flag the slot as inactive and make it available for reuse
+	m_ActiveNodes.Reset(node);
+	--m_iNumActiveNodes;
+	m_FreeNodeIndices.push_back(node);
+
 	//if the graph is not directed remove all edges leading to this node and then
 	//clear the edges leading from the node
 	//if (!m_bDigraph)
@@ -736,10 +955,10 @@ bool SparseGraph<node_type, edge_type>::Save(std::ofstream& stream)const
 	stream << m_Nodes.size() << std::endl;
 
 	//iterate through the graph nodes and save them
-	NodeVector::const_iterator curNode = m_Nodes.begin();
+	typename NodeVector::const_iterator curNode = m_Nodes.begin();
 	for (curNode; curNode != m_Nodes.end(); ++curNode)
 	{
-		curNode->SaveNode(stream);
+		SaveNode(stream, *curNode);
 	}
 
 	//save the number of edges
@@ -758,6 +977,195 @@ bool SparseGraph<node_type, edge_type>::Save(std::ofstream& stream)const
 	return true;
 }
 
+//----------------------------- SaveBinary ------------------------------------
+//
+//  Writes the node count, the node vector, the edge count, every edge and
+//  then the free list (count and indices) as raw bytes, so placeholder slots
+//  stay off it. Only available for trivially copyable node and edge types.
+//-----------------------------------------------------------------------------
+template <class node_type, class edge_type>
+bool SparseGraph<node_type, edge_type>::SaveBinary(std::ostream& stream)const
+{
+	static_assert(GraphElementTraits<node_type>::is_bulk_copyable && GraphElementTraits<edge_type>::is_bulk_copyable,
+		"<SparseGraph::SaveBinary>: node and edge types must be trivially copyable");
+
+	int numNodes = (int)m_Nodes.size();
+	stream.write(reinterpret_cast<const char*>(&numNodes), sizeof(numNodes));
+
+	if (numNodes > 0)
+	{
+		stream.write(reinterpret_cast<const char*>(&m_Nodes[0]), sizeof(node_type) * numNodes);
+	}
+
+	//flatten the adjacency lists so the edges go out in one write
+	std::vector<edge_type> edges;
+	edges.reserve(NumEdges());
+
+	for (int nodeIdx = 0; nodeIdx < numNodes; ++nodeIdx)
+	{
+		edges.insert(edges.end(), m_Edges[nodeIdx].begin(), m_Edges[nodeIdx].end());
+	}
+
+	int numEdges = (int)edges.size();
+	stream.write(reinterpret_cast<const char*>(&numEdges), sizeof(numEdges));
+
+	if (numEdges > 0)
+	{
+		stream.write(reinterpret_cast<const char*>(&edges[0]), sizeof(edge_type) * numEdges);
+	}
+
+	int numFree = (int)m_FreeNodeIndices.size();
+	stream.write(reinterpret_cast<const char*>(&numFree), sizeof(numFree));
+
+	if (numFree > 0)
+	{
+		stream.write(reinterpret_cast<const char*>(&m_FreeNodeIndices[0]), sizeof(int) * numFree);
+	}
+
+	return stream.good();
+}
+
+//----------------------------- LoadBinary ------------------------------------
+//
+//  Reads a graph written by SaveBinary. Nodes saved with an invalid index are
+//  kept as inactive slots so the indices of the other nodes are preserved,
+//  and only the slots on the saved free list are handed out again.
+//  Returns false and leaves the graph empty if the file is truncated, a
+//  node's index is neither its slot nor invalid, any edge leads from or to a
+//  node that is out of range or was saved invalid, or the free list names an
+//  active slot or one slot twice.
+//-----------------------------------------------------------------------------
+template <class node_type, class edge_type>
+bool SparseGraph<node_type, edge_type>::LoadBinary(std::istream& stream)
+{
+	static_assert(GraphElementTraits<node_type>::is_bulk_copyable && GraphElementTraits<edge_type>::is_bulk_copyable,
+		"<SparseGraph::LoadBinary>: node and edge types must be trivially copyable");
+
+	Clear();
+
+	//bytes left in the stream, or -1 if it can't seek; counts read from the
+	//file are checked against it before anything is sized by them
+	const std::streampos start = stream.tellg();
+	std::streamoff remaining = -1;
+
+	if (start != std::streampos(-1) && stream.seekg(0, std::ios::end))
+	{
+		remaining = stream.tellg() - start;
+		stream.seekg(start);
+	}
+
+	stream.clear();
+
+	int numNodes = 0;
+	stream.read(reinterpret_cast<char*>(&numNodes), sizeof(numNodes));
+
+	if (!stream || numNodes < 0 ||
+		(remaining >= 0 && (std::streamoff)sizeof(node_type) * numNodes > remaining))
+	{
+		return false;
+	}
+
+	std::vector<node_type> nodes(numNodes);
+
+	if (numNodes > 0)
+	{
+		stream.read(reinterpret_cast<char*>(&nodes[0]), sizeof(node_type) * numNodes);
+	}
+
+	int numEdges = 0;
+	stream.read(reinterpret_cast<char*>(&numEdges), sizeof(numEdges));
+
+	if (!stream || numEdges < 0 ||
+		(remaining >= 0 && (std::streamoff)sizeof(edge_type) * numEdges > remaining))
+	{
+		return false;
+	}
+
+	std::vector<edge_type> edges(numEdges);
+
+	if (numEdges > 0)
+	{
+		stream.read(reinterpret_cast<char*>(&edges[0]), sizeof(edge_type) * numEdges);
+	}
+
+	int numFree = 0;
+	stream.read(reinterpret_cast<char*>(&numFree), sizeof(numFree));
+
+	if (!stream || numFree < 0 || numFree > numNodes)
+	{
+		return false;
+	}
+
+	std::vector<int> freeNodes(numFree);
+
+	if (numFree > 0)
+	{
+		stream.read(reinterpret_cast<char*>(&freeNodes[0]), sizeof(int) * numFree);
+	}
+
+	if (stream.fail())
+	{
+		return false;
+	}
+
+	//check every node and edge before building anything
+	for (int n = 0; n < numNodes; ++n)
+	{
+		if (nodes[n].Index() != n && nodes[n].Index() != invalid_node_index)
+		{
+			return false;
+		}
+	}
+
+	for (int e = 0; e < numEdges; ++e)
+	{
+		const int from = edges[e].From();
+		const int to = edges[e].To();
+
+		if (from < 0 || from >= numNodes || to < 0 || to >= numNodes ||
+			nodes[from].Index() == invalid_node_index || nodes[to].Index() == invalid_node_index)
+		{
+			return false;
+		}
+	}
+
+	std::vector<char> isFree(numNodes, 0);
+
+	for (int f = 0; f < numFree; ++f)
+	{
+		const int n = freeNodes[f];
+
+		if (n < 0 || n >= numNodes || nodes[n].Index() != invalid_node_index || isFree[n])
+		{
+			return false;
+		}
+
+		isFree[n] = 1;
+	}
+
+	m_Nodes.swap(nodes);
+	m_FreeNodeIndices.swap(freeNodes);
+	m_Edges.resize(numNodes);
+	m_ActiveNodes.Resize(numNodes);
+	m_iNextNodeIndex = numNodes;
+
+	for (int n = 0; n < numNodes; ++n)
+	{
+		if (m_Nodes[n].Index() != invalid_node_index)
+		{
+			m_ActiveNodes.Set(n);
+			++m_iNumActiveNodes;
+		}
+	}
+
+	for (int e = 0; e < numEdges; ++e)
+	{
+		m_Edges[edges[e].From()].push_back(edges[e]);
+	}
+
+	return true;
+}
+
 //------------------------------- Load ----------------------------------------
 //-----------------------------------------------------------------------------
 template <class node_type, class edge_type>
@@ -810,11 +1218,11 @@ bool SparseGraph<node_type, edge_type>::Load(std::ifstream& stream)
 		stream >> nodeIndex;
 
 		stream >> test;
-		int posX;
+		float posX;
 		stream >> posX;
 
 		stream >> test;
-		int posZ;
+		float posZ;
 		stream >> posZ;
 
 		NodeType NewNode(nodeIndex);
@@ -835,12 +1243,7 @@ bool SparseGraph<node_type, edge_type>::Load(std::ifstream& stream)
 		}
 		else
 		{
-			m_Nodes.push_back(NewNode);
-
-			//make sure an edgelist is added for each node
-			m_Edges.push_back(EdgeList());
-
-			++m_iNextNodeIndex;
+			PushInactiveNode(NewNode);
 		}
 	}
 
@@ -948,12 +1351,7 @@ bool SparseGraph<node_type, edge_type>::Load(std::vector<std::string> data)
 		}
 		else
 		{
-			m_Nodes.push_back(NewNode);
-
-			//make sure an edgelist is added for each node
-			m_Edges.push_back(EdgeList());
-
-			++m_iNextNodeIndex;
+			PushInactiveNode(NewNode);
 		}
 	}
 
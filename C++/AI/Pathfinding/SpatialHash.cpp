@@ -0,0 +1,90 @@
+#include <AI/Pathfinding/SpatialHash.h>
+
+namespace Rebellion
+{
+	SpatialHash::SpatialHash(float a_cellSize, int a_tableSize)
+		: m_CellSize(a_cellSize)
+		, m_InvCellSize(1.f / a_cellSize)
+	{
+		int tableSize = 1;
+		while (tableSize < a_tableSize)
+		{
+			tableSize <<= 1;
+		}
+
+		m_TableMask = tableSize - 1;
+		m_BucketStart.assign(tableSize + 1, 0);
+	}
+
+	void SpatialHash::Build(const float* a_positionX, const float* a_positionZ, int a_count)
+	{
+		const int tableSize = m_TableMask + 1;
+
+		m_AgentBucket.resize(a_count);
+		m_SortedAgents.resize(a_count);
+		m_SortedX.resize(a_count);
+		m_SortedZ.resize(a_count);
+		m_SortedCellX.resize(a_count);
+		m_SortedCellZ.resize(a_count);
+
+		//Count the agents in each bucket
+		for (int b = 0; b <= tableSize; ++b)
+		{
+			m_BucketStart[b] = 0;
+		}
+
+		for (int i = 0; i < a_count; ++i)
+		{
+			int bucket = HashCell(CellCoord(a_positionX[i]), CellCoord(a_positionZ[i]));
+			m_AgentBucket[i] = bucket;
+			++m_BucketStart[bucket + 1];
+		}
+
+		//Prefix sum turns the counts into bucket start offsets
+		for (int b = 0; b < tableSize; ++b)
+		{
+			m_BucketStart[b + 1] += m_BucketStart[b];
+		}
+
+		//Scatter, using each bucket's start as its running insert position, then shift the starts back
+		for (int i = 0; i < a_count; ++i)
+		{
+			int slot = m_BucketStart[m_AgentBucket[i]]++;
+
+			m_SortedAgents[slot] = i;
+			m_SortedX[slot] = a_positionX[i];
+			m_SortedZ[slot] = a_positionZ[i];
+			m_SortedCellX[slot] = CellCoord(a_positionX[i]);
+			m_SortedCellZ[slot] = CellCoord(a_positionZ[i]);
+		}
+
+		for (int b = tableSize; b > 0; --b)
+		{
+			m_BucketStart[b] = m_BucketStart[b - 1];
+		}
+
+		m_BucketStart[0] = 0;
+	}
+
+	int SpatialHash::QueryNeighbours(float a_x, float a_z, float a_radius, int* a_neighbours, int a_maxNeighbours, int a_excludeAgent) const
+	{
+		int numFound = 0;
+
+		if (a_maxNeighbours <= 0)
+		{
+			return 0;
+		}
+
+		ForEachNeighbour(a_x, a_z, a_radius, [&](int a_agent, float)
+		{
+			if (a_agent != a_excludeAgent)
+			{
+				a_neighbours[numFound++] = a_agent;
+			}
+
+			return numFound < a_maxNeighbours;
+		});
+
+		return numFound;
+	}
+}
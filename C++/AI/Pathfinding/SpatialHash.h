@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+namespace Rebellion
+{
+	//Uniform spatial hash over the XZ plane, rebuilt every frame. Build() counting-sorts the agents by hashed cell,
+	//so the agents in a cell (and their positions) are contiguous in memory and a neighbour query only touches the
+	//handful of cells overlapping its radius: O(n * k) per frame for n agents with k neighbours, instead of O(n^2).
+	//Works best with the cell size close to the usual query radius.
+	class SpatialHash
+	{
+	public:
+		SpatialHash(float a_cellSize, int a_tableSize = 4096); //Table size is rounded up to a power of two
+
+		void Build(const float* a_positionX, const float* a_positionZ, int a_count);
+
+		//Calls a_visitor(agentIndex, distanceSq) for every agent within a_radius of (a_x, a_z), including any agent at
+		//that exact position. a_visitor returns false to stop the query early.
+		template <class visitor_type>
+		void ForEachNeighbour(float a_x, float a_z, float a_radius, visitor_type a_visitor) const;
+
+		//Writes up to a_maxNeighbours agent indices (other than a_excludeAgent) within a_radius into a_neighbours and
+		//returns how many were written
+		int QueryNeighbours(float a_x, float a_z, float a_radius, int* a_neighbours, int a_maxNeighbours, int a_excludeAgent = -1) const;
+
+		int NumAgents() const { return (int)m_SortedAgents.size(); }
+		float GetCellSize() const { return m_CellSize; }
+
+		//Agents in cell order. Iterating agents in this order keeps their neighbours' data warm in cache.
+		const std::vector<int>& GetSortedAgents() const { return m_SortedAgents; }
+	private:
+		int CellCoord(float a_value) const { return (int)std::floor(a_value * m_InvCellSize); }
+		int HashCell(int a_cellX, int a_cellZ) const { return (int)(((unsigned int)a_cellX * 73856093u) ^ ((unsigned int)a_cellZ * 19349663u)) & m_TableMask; }
+
+		float m_CellSize;
+		float m_InvCellSize;
+		int m_TableMask;
+
+		std::vector<int> m_BucketStart; //Start of each bucket in the sorted arrays (table size + 1 entries)
+		std::vector<int> m_SortedAgents;
+		std::vector<float> m_SortedX; //Positions copied into bucket order
+		std::vector<float> m_SortedZ;
+		std::vector<int> m_SortedCellX; //Unhashed cell of each entry, so colliding cells in one bucket can be told apart
+		std::vector<int> m_SortedCellZ;
+		std::vector<int> m_AgentBucket; //Scratch used during Build
+	};
+
+	template <class visitor_type>
+	void SpatialHash::ForEachNeighbour(float a_x, float a_z, float a_radius, visitor_type a_visitor) const
+	{
+		const float radiusSq = a_radius * a_radius;
+
+		const int minCellX = CellCoord(a_x - a_radius);
+		const int maxCellX = CellCoord(a_x + a_radius);
+		const int minCellZ = CellCoord(a_z - a_radius);
+		const int maxCellZ = CellCoord(a_z + a_radius);
+
+		for (int cellZ = minCellZ; cellZ <= maxCellZ; ++cellZ)
+		{
+			for (int cellX = minCellX; cellX <= maxCellX; ++cellX)
+			{
+				const int bucket = HashCell(cellX, cellZ);
+
+				for (int i = m_BucketStart[bucket]; i < m_BucketStart[bucket + 1]; ++i)
+				{
+					//Another cell may hash to the same bucket; it is visited (or skipped) on its own iteration
+					if (m_SortedCellX[i] != cellX || m_SortedCellZ[i] != cellZ)
+					{
+						continue;
+					}
+
+					const float dx = m_SortedX[i] - a_x;
+					const float dz = m_SortedZ[i] - a_z;
+					const float distanceSq = dx * dx + dz * dz;
+
+					if (distanceSq <= radiusSq && !a_visitor(m_SortedAgents[i], distanceSq))
+					{
+						return;
+					}
+				}
+			}
+		}
+	}
+}
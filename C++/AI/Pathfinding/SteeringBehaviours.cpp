@@ -1,4 +1,233 @@
 #include <AI/Pathfinding/SteeringBehaviours.h>
+#include <AI/Pathfinding/ThreadPool.h>
+#include <AI/Pathfinding/SpatialHash.h>
+
+namespace
+{
+	const float k_ArriveSlowingRadius = 25.f;
+	const float k_ArriveOnPathSlowingRadius = 70.f;
+	const int k_BatchChunkSize = 1024; //Multiple of 4, so only the last chunk has agents left over for the scalar path
+
+	enum BatchBehaviour
+	{
+		Batch_Seek,
+		Batch_Arrive,
+		Batch_ArriveOnPath
+	};
+
+	inline DirectX::XMVECTOR LoadLanes(const float* a_values, int a_index)
+	{
+		return DirectX::XMLoadFloat4(reinterpret_cast<const DirectX::XMFLOAT4*>(a_values + a_index));
+	}
+
+	inline void StoreLanes(float* a_values, int a_index, DirectX::FXMVECTOR a_lanes)
+	{
+		DirectX::XMStoreFloat4(reinterpret_cast<DirectX::XMFLOAT4*>(a_values + a_index), a_lanes);
+	}
+
+	//1/length per lane, or 0 for zero length vectors so they "normalise" to zero like XMVector3Normalize
+	inline DirectX::XMVECTOR ReciprocalLength(DirectX::FXMVECTOR a_lengthSq)
+	{
+		DirectX::XMVECTOR zero = DirectX::XMVectorZero();
+		return DirectX::XMVectorSelect(DirectX::XMVectorReciprocalSqrt(a_lengthSq), zero, DirectX::XMVectorEqual(a_lengthSq, zero));
+	}
+
+	//Steers the four agents starting at a_index. Each XMVECTOR holds one component for four agents.
+	template <int behaviour>
+	void SteerLanes(const Rebellion::SteeringBatch& a_batch, int a_index, float a_maxSpeed, float a_maxForce)
+	{
+		DirectX::XMVECTOR posX = LoadLanes(a_batch.positionX, a_index);
+		DirectX::XMVECTOR posY = LoadLanes(a_batch.positionY, a_index);
+		DirectX::XMVECTOR posZ = LoadLanes(a_batch.positionZ, a_index);
+
+		DirectX::XMVECTOR desiredX = DirectX::XMVectorSubtract(LoadLanes(a_batch.targetX, a_index), posX);
+		DirectX::XMVECTOR desiredY = DirectX::XMVectorSubtract(LoadLanes(a_batch.targetY, a_index), posY);
+		DirectX::XMVECTOR desiredZ = DirectX::XMVectorSubtract(LoadLanes(a_batch.targetZ, a_index), posZ);
+
+		DirectX::XMVECTOR lengthSq = DirectX::XMVectorMultiply(desiredX, desiredX);
+		lengthSq = DirectX::XMVectorMultiplyAdd(desiredY, desiredY, lengthSq);
+		lengthSq = DirectX::XMVectorMultiplyAdd(desiredZ, desiredZ, lengthSq);
+
+		DirectX::XMVECTOR invLength = ReciprocalLength(lengthSq);
+		DirectX::XMVECTOR speed = DirectX::XMVectorReplicate(a_maxSpeed);
+
+		if (behaviour == Batch_Arrive)
+		{
+			DirectX::XMVECTOR length = DirectX::XMVectorMultiply(lengthSq, invLength);
+			DirectX::XMVECTOR slowed = DirectX::XMVectorScale(length, a_maxSpeed / k_ArriveSlowingRadius);
+			speed = DirectX::XMVectorSelect(speed, slowed, DirectX::XMVectorLess(length, DirectX::XMVectorReplicate(k_ArriveSlowingRadius)));
+		}
+		else if (behaviour == Batch_ArriveOnPath)
+		{
+			DirectX::XMVECTOR toDestX = DirectX::XMVectorSubtract(LoadLanes(a_batch.destinationX, a_index), posX);
+			DirectX::XMVECTOR toDestY = DirectX::XMVectorSubtract(LoadLanes(a_batch.destinationY, a_index), posY);
+			DirectX::XMVECTOR toDestZ = DirectX::XMVectorSubtract(LoadLanes(a_batch.destinationZ, a_index), posZ);
+
+			DirectX::XMVECTOR distanceSq = DirectX::XMVectorMultiply(toDestX, toDestX);
+			distanceSq = DirectX::XMVectorMultiplyAdd(toDestY, toDestY, distanceSq);
+			distanceSq = DirectX::XMVectorMultiplyAdd(toDestZ, toDestZ, distanceSq);
+
+			DirectX::XMVECTOR distance = DirectX::XMVectorSqrt(distanceSq);
+			DirectX::XMVECTOR slowed = DirectX::XMVectorScale(distance, a_maxSpeed / k_ArriveOnPathSlowingRadius);
+			speed = DirectX::XMVectorSelect(speed, slowed, DirectX::XMVectorLess(distance, DirectX::XMVectorReplicate(k_ArriveOnPathSlowingRadius)));
+		}
+
+		//steering force = normalised desired velocity * speed - velocity
+		DirectX::XMVECTOR scale = DirectX::XMVectorMultiply(invLength, speed);
+		DirectX::XMVECTOR forceX = DirectX::XMVectorSubtract(DirectX::XMVectorMultiply(desiredX, scale), LoadLanes(a_batch.velocityX, a_index));
+		DirectX::XMVECTOR forceY = DirectX::XMVectorSubtract(DirectX::XMVectorMultiply(desiredY, scale), LoadLanes(a_batch.velocityY, a_index));
+		DirectX::XMVECTOR forceZ = DirectX::XMVectorSubtract(DirectX::XMVectorMultiply(desiredZ, scale), LoadLanes(a_batch.velocityZ, a_index));
+
+		//Truncate to a_maxForce, only rescaling the lanes that are over it
+		DirectX::XMVECTOR forceSq = DirectX::XMVectorMultiply(forceX, forceX);
+		forceSq = DirectX::XMVectorMultiplyAdd(forceY, forceY, forceSq);
+		forceSq = DirectX::XMVectorMultiplyAdd(forceZ, forceZ, forceSq);
+
+		DirectX::XMVECTOR tooLong = DirectX::XMVectorGreater(forceSq, DirectX::XMVectorReplicate(a_maxForce * a_maxForce));
+		DirectX::XMVECTOR truncate = DirectX::XMVectorScale(DirectX::XMVectorReciprocalSqrt(forceSq), a_maxForce);
+		DirectX::XMVECTOR forceScale = DirectX::XMVectorSelect(DirectX::XMVectorReplicate(1.f), truncate, tooLong);
+
+		StoreLanes(a_batch.forceX, a_index, DirectX::XMVectorMultiply(forceX, forceScale));
+		StoreLanes(a_batch.forceY, a_index, DirectX::XMVectorMultiply(forceY, forceScale));
+		StoreLanes(a_batch.forceZ, a_index, DirectX::XMVectorMultiply(forceZ, forceScale));
+	}
+
+	//Single agent fallback for the agents left over after the last group of four
+	template <int behaviour>
+	void SteerSingle(const Rebellion::SteeringBatch& a_batch, int a_index, float a_maxSpeed, float a_maxForce)
+	{
+		DirectX::XMVECTOR position = DirectX::XMVectorSet(a_batch.positionX[a_index], a_batch.positionY[a_index], a_batch.positionZ[a_index], 0.f);
+		DirectX::XMVECTOR velocity = DirectX::XMVectorSet(a_batch.velocityX[a_index], a_batch.velocityY[a_index], a_batch.velocityZ[a_index], 0.f);
+		DirectX::XMVECTOR target = DirectX::XMVectorSet(a_batch.targetX[a_index], a_batch.targetY[a_index], a_batch.targetZ[a_index], 0.f);
+		DirectX::XMVECTOR force;
+
+		if (behaviour == Batch_Seek)
+		{
+			force = Rebellion::SteeringBehaviours::Seek(target, position, velocity, a_maxSpeed, a_maxForce);
+		}
+		else if (behaviour == Batch_Arrive)
+		{
+			force = Rebellion::SteeringBehaviours::Arrive(target, position, velocity, a_maxSpeed, a_maxForce);
+		}
+		else
+		{
+			DirectX::XMVECTOR destination = DirectX::XMVectorSet(a_batch.destinationX[a_index], a_batch.destinationY[a_index], a_batch.destinationZ[a_index], 0.f);
+			force = Rebellion::SteeringBehaviours::ArriveOnPath(destination, target, position, velocity, a_maxSpeed, a_maxForce);
+		}
+
+		a_batch.forceX[a_index] = DirectX::XMVectorGetX(force);
+		a_batch.forceY[a_index] = DirectX::XMVectorGetY(force);
+		a_batch.forceZ[a_index] = DirectX::XMVectorGetZ(force);
+	}
+
+	template <int behaviour>
+	void SteerBatch(const Rebellion::SteeringBatch& a_batch, float a_maxSpeed, float a_maxForce)
+	{
+		ThreadPool::Get().ParallelFor(a_batch.count, k_BatchChunkSize, [&](int a_begin, int a_end)
+		{
+			int i = a_begin;
+
+			for (; i + 4 <= a_end; i += 4)
+			{
+				SteerLanes<behaviour>(a_batch, i, a_maxSpeed, a_maxForce);
+			}
+
+			for (; i < a_end; ++i)
+			{
+				SteerSingle<behaviour>(a_batch, i, a_maxSpeed, a_maxForce);
+			}
+		});
+	}
+
+	enum FlockBehaviour
+	{
+		Flock_Separation,
+		Flock_Alignment,
+		Flock_Cohesion
+	};
+
+	template <int behaviour>
+	void FlockSingle(const Rebellion::SteeringBatch& a_batch, const Rebellion::SpatialHash& a_hash, int a_agent, float a_radius, float a_maxSpeed, float a_maxForce)
+	{
+		const float x = a_batch.positionX[a_agent];
+		const float z = a_batch.positionZ[a_agent];
+
+		float sumX = 0.f;
+		float sumZ = 0.f;
+		int numNeighbours = 0;
+
+		a_hash.ForEachNeighbour(x, z, a_radius, [&](int a_neighbour, float a_distanceSq)
+		{
+			if (a_neighbour == a_agent)
+			{
+				return true;
+			}
+
+			if (behaviour == Flock_Separation)
+			{
+				if (a_distanceSq > 0.f) //(p - q) / |p - q|^2 is the direction away scaled by 1/distance
+				{
+					sumX += (x - a_batch.positionX[a_neighbour]) / a_distanceSq;
+					sumZ += (z - a_batch.positionZ[a_neighbour]) / a_distanceSq;
+				}
+			}
+			else if (behaviour == Flock_Alignment)
+			{
+				sumX += a_batch.velocityX[a_neighbour];
+				sumZ += a_batch.velocityZ[a_neighbour];
+			}
+			else
+			{
+				sumX += a_batch.positionX[a_neighbour];
+				sumZ += a_batch.positionZ[a_neighbour];
+			}
+
+			++numNeighbours;
+			return true;
+		});
+
+		DirectX::XMVECTOR force = DirectX::XMVectorZero();
+
+		if (numNeighbours > 0)
+		{
+			const float invCount = 1.f / numNeighbours;
+			DirectX::XMVECTOR velocity = DirectX::XMVectorSet(a_batch.velocityX[a_agent], 0.f, a_batch.velocityZ[a_agent], 0.f);
+
+			if (behaviour == Flock_Separation)
+			{
+				force = Rebellion::SteeringBehaviours::Truncate(DirectX::XMVectorSet(sumX, 0.f, sumZ, 0.f), a_maxForce);
+			}
+			else if (behaviour == Flock_Alignment)
+			{
+				DirectX::XMVECTOR averageVelocity = DirectX::XMVectorSet(sumX * invCount, 0.f, sumZ * invCount, 0.f);
+				force = Rebellion::SteeringBehaviours::Truncate(DirectX::XMVectorSubtract(averageVelocity, velocity), a_maxForce);
+			}
+			else
+			{
+				DirectX::XMVECTOR centre = DirectX::XMVectorSet(sumX * invCount, 0.f, sumZ * invCount, 0.f);
+				force = Rebellion::SteeringBehaviours::Seek(centre, DirectX::XMVectorSet(x, 0.f, z, 0.f), velocity, a_maxSpeed, a_maxForce);
+			}
+		}
+
+		a_batch.forceX[a_agent] = DirectX::XMVectorGetX(force);
+		a_batch.forceY[a_agent] = 0.f;
+		a_batch.forceZ[a_agent] = DirectX::XMVectorGetZ(force);
+	}
+
+	template <int behaviour>
+	void FlockBatch(const Rebellion::SteeringBatch& a_batch, const Rebellion::SpatialHash& a_hash, float a_radius, float a_maxSpeed, float a_maxForce)
+	{
+		const std::vector<int>& sortedAgents = a_hash.GetSortedAgents();
+
+		ThreadPool::Get().ParallelFor((int)sortedAgents.size(), k_BatchChunkSize, [&](int a_begin, int a_end)
+		{
+			for (int i = a_begin; i < a_end; ++i)
+			{
+				FlockSingle<behaviour>(a_batch, a_hash, sortedAgents[i], a_radius, a_maxSpeed, a_maxForce);
+			}
+		});
+	}
+}
 
 namespace Rebellion
 {
@@ -24,7 +253,7 @@ namespace Rebellion
 		float desiredVelocityLength = DirectX::XMVectorGetX(DirectX::XMVector3Length(desiredVelocity));
 		desiredVelocity = DirectX::XMVector3Normalize(desiredVelocity);
 
-		float slowingRadius = 25.f;
+		float slowingRadius = k_ArriveSlowingRadius;
 
 		if (desiredVelocityLength < slowingRadius)
 		{
@@ -48,7 +277,7 @@ namespace Rebellion
 		DirectX::XMVECTOR distanceToDestination = DirectX::XMVectorSubtract(a_finalDestination, a_position);
 		float distanceToDestinationLength = DirectX::XMVectorGetX(DirectX::XMVector3Length(distanceToDestination));
 
-		float slowingRadius = 70.f;
+		float slowingRadius = k_ArriveOnPathSlowingRadius;
 
 		if (distanceToDestinationLength < slowingRadius)
 		{
@@ -76,4 +305,34 @@ namespace Rebellion
 
 		return a_vector;
 	}
+
+	void SteeringBehaviours::SeekBatch(const SteeringBatch& a_batch, float a_maxSpeed, float a_maxForce)
+	{
+		SteerBatch<Batch_Seek>(a_batch, a_maxSpeed, a_maxForce);
+	}
+
+	void SteeringBehaviours::ArriveBatch(const SteeringBatch& a_batch, float a_maxSpeed, float a_maxForce)
+	{
+		SteerBatch<Batch_Arrive>(a_batch, a_maxSpeed, a_maxForce);
+	}
+
+	void SteeringBehaviours::ArriveOnPathBatch(const SteeringBatch& a_batch, float a_maxSpeed, float a_maxForce)
+	{
+		SteerBatch<Batch_ArriveOnPath>(a_batch, a_maxSpeed, a_maxForce);
+	}
+
+	void SteeringBehaviours::SeparationBatch(const SteeringBatch& a_batch, const SpatialHash& a_hash, float a_radius, float a_maxForce)
+	{
+		FlockBatch<Flock_Separation>(a_batch, a_hash, a_radius, 0.f, a_maxForce);
+	}
+
+	void SteeringBehaviours::AlignmentBatch(const SteeringBatch& a_batch, const SpatialHash& a_hash, float a_radius, float a_maxForce)
+	{
+		FlockBatch<Flock_Alignment>(a_batch, a_hash, a_radius, 0.f, a_maxForce);
+	}
+
+	void SteeringBehaviours::CohesionBatch(const SteeringBatch& a_batch, const SpatialHash& a_hash, float a_radius, float a_maxSpeed, float a_maxForce)
+	{
+		FlockBatch<Flock_Cohesion>(a_batch, a_hash, a_radius, a_maxSpeed, a_maxForce);
+	}
 }
\ No newline at end of file
@@ -4,6 +4,30 @@
 
 namespace Rebellion
 {
+	class SpatialHash;
+
+	//Structure-of-arrays agent data for the batch behaviours. Every array holds count floats.
+	//destination* is only read by ArriveOnPathBatch.
+	struct SteeringBatch
+	{
+		int count;
+		const float* positionX;
+		const float* positionY;
+		const float* positionZ;
+		const float* velocityX;
+		const float* velocityY;
+		const float* velocityZ;
+		const float* targetX;
+		const float* targetY;
+		const float* targetZ;
+		const float* destinationX;
+		const float* destinationY;
+		const float* destinationZ;
+		float* forceX; //Output steering forces
+		float* forceY;
+		float* forceZ;
+	};
+
 	class SteeringBehaviours
 	{
 	public:
@@ -20,6 +44,19 @@ namespace Rebellion
 
 		static DirectX::XMVECTOR Truncate(DirectX::XMVECTOR a_vector, float a_value); //Truncates vector to value
 
+		//Batch versions of the behaviours above. Agents are processed four per vector with one reciprocal square root
+		//per normalise, and the batch is split into chunks across ThreadPool::Get(). Results match the single agent
+		//versions to within floating point tolerance.
+		static void SeekBatch(const SteeringBatch& a_batch, float a_maxSpeed, float a_maxForce);
+		static void ArriveBatch(const SteeringBatch& a_batch, float a_maxSpeed, float a_maxForce);
+		static void ArriveOnPathBatch(const SteeringBatch& a_batch, float a_maxSpeed, float a_maxForce);
+
+		//Flocking behaviours over the XZ plane (force Y is zero). a_hash must have been built from the batch positions this
+		//frame; neighbours are the other agents within a_radius. Agents are visited in the hash's cell order, in parallel.
+		static void SeparationBatch(const SteeringBatch& a_batch, const SpatialHash& a_hash, float a_radius, float a_maxForce); //Steers away from neighbours, weighted by 1/distance
+		static void AlignmentBatch(const SteeringBatch& a_batch, const SpatialHash& a_hash, float a_radius, float a_maxForce); //Steers towards neighbours' average velocity
+		static void CohesionBatch(const SteeringBatch& a_batch, const SpatialHash& a_hash, float a_radius, float a_maxSpeed, float a_maxForce); //Seeks neighbours' centre
+
 	private:
 
 	};
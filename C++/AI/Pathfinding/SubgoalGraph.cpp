@@ -0,0 +1,331 @@
+#include <AI/Pathfinding/SubgoalGraph.h>
+
+#include <AI/Pathfinding/Graph_SearchAStar.h>
+#include <AI/Pathfinding/Heuristics.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+	const int k_CardinalX[4] = { 1, -1, 0, 0 };
+	const int k_CardinalY[4] = { 0, 0, 1, -1 };
+	const int k_DiagonalX[4] = { 1, 1, -1, -1 };
+	const int k_DiagonalY[4] = { 1, -1, 1, -1 };
+
+	float OctileDistance(int a_dx, int a_dy)
+	{
+		a_dx = std::abs(a_dx);
+		a_dy = std::abs(a_dy);
+		return (a_dx > a_dy) ? a_dx + 0.41421356f * a_dy : a_dy + 0.41421356f * a_dx;
+	}
+
+	int Sign(int a_value)
+	{
+		return (a_value > 0) - (a_value < 0);
+	}
+}
+
+SubgoalGraph::SubgoalGraph(const GridMask& a_mask)
+	: m_Mask(a_mask)
+	, m_Graph(false)
+	, m_NumSubgoals(0)
+	, m_LastPathCost(0.f)
+{
+	Build();
+}
+
+void SubgoalGraph::Build()
+{
+	const int width = m_Mask.Width();
+	const int height = m_Mask.Height();
+
+	m_Graph.Clear();
+	m_IsSubgoal = Bitset(m_Mask.NumCells());
+	m_NodeOfCell.assign(m_Mask.NumCells(), invalid_node_index);
+	m_NumSubgoals = 0;
+
+	//A walkable cell is a subgoal if it sits diagonally next to a blocked cell that it could otherwise step past, i.e.
+	//both cells between them are walkable: the convex corner of an obstacle
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			if (!m_Mask.IsWalkable(x, y))
+			{
+				continue;
+			}
+
+			for (int d = 0; d < 4; ++d)
+			{
+				const int dx = k_DiagonalX[d];
+				const int dy = k_DiagonalY[d];
+
+				if (m_Mask.InBounds(x + dx, y + dy) && !m_Mask.IsWalkable(x + dx, y + dy) &&
+					m_Mask.IsWalkable(x + dx, y) && m_Mask.IsWalkable(x, y + dy))
+				{
+					m_IsSubgoal.Set(m_Mask.CellIndex(x, y));
+					AddNodeForCell(m_Mask.CellIndex(x, y));
+					++m_NumSubgoals;
+					break;
+				}
+			}
+		}
+	}
+
+	for (int n = 0; n < m_Graph.NumNodes(); ++n)
+	{
+		const DirectX::XMFLOAT3& position = m_Graph.GetNode(n).GetPositionF3();
+
+		ConnectToReachable(n, (int)position.x, (int)position.z);
+	}
+}
+
+int SubgoalGraph::AddNodeForCell(int a_cell)
+{
+	const int x = a_cell % m_Mask.Width();
+	const int y = a_cell / m_Mask.Width();
+
+	//Temporary query nodes reuse slots freed by the previous query
+	const int node = m_Graph.AddNode(NavNode(m_Graph.GetNextFreeNodeIndex(), DirectX::XMFLOAT3((float)x, 0.f, (float)y)));
+
+	m_NodeOfCell[a_cell] = node;
+
+	return node;
+}
+
+void SubgoalGraph::ConnectToReachable(int a_node, int a_x, int a_y)
+{
+	FindDirectHReachable(a_x, a_y);
+
+	for (size_t i = 0; i < m_Reachable.size(); ++i)
+	{
+		const int cell = m_Reachable[i];
+		const int dx = cell % m_Mask.Width() - a_x;
+		const int dy = cell / m_Mask.Width() - a_y;
+
+		//Undirected graph, so this also adds the edge back
+		m_Graph.AddEdge(NavEdge(a_node, m_NodeOfCell[cell], OctileDistance(dx, dy)));
+	}
+}
+
+bool SubgoalGraph::CanStep(int a_x, int a_y, int a_dx, int a_dy) const
+{
+	if (a_dx != 0 && a_dy != 0)
+	{
+		return m_Mask.CanMoveDiagonal(a_x, a_y, a_dx, a_dy, diagonal_both_sides_open);
+	}
+
+	return m_Mask.IsWalkable(a_x + a_dx, a_y + a_dy);
+}
+
+int SubgoalGraph::Clearance(int a_x, int a_y, int a_dx, int a_dy, bool& a_hitSubgoal) const
+{
+	int steps = 0;
+
+	a_hitSubgoal = false;
+
+	while (CanStep(a_x, a_y, a_dx, a_dy))
+	{
+		a_x += a_dx;
+		a_y += a_dy;
+
+		if (m_IsSubgoal.Test(m_Mask.CellIndex(a_x, a_y)))
+		{
+			a_hitSubgoal = true;
+			break;
+		}
+
+		++steps;
+	}
+
+	return steps;
+}
+
+void SubgoalGraph::FindDirectHReachable(int a_x, int a_y)
+{
+	m_Reachable.clear();
+
+	bool hitSubgoal;
+	int cardinalClearance[4];
+
+	for (int c = 0; c < 4; ++c)
+	{
+		const int dx = k_CardinalX[c];
+		const int dy = k_CardinalY[c];
+
+		cardinalClearance[c] = Clearance(a_x, a_y, dx, dy, hitSubgoal);
+
+		if (hitSubgoal)
+		{
+			m_Reachable.push_back(m_Mask.CellIndex(a_x + (cardinalClearance[c] + 1) * dx, a_y + (cardinalClearance[c] + 1) * dy));
+		}
+	}
+
+	for (int d = 0; d < 4; ++d)
+	{
+		const int dx = k_DiagonalX[d];
+		const int dy = k_DiagonalY[d];
+
+		//Cardinal scans off the diagonal only run as far as the previous scan did, so nothing found is hidden behind a
+		//subgoal or obstacle closer to the start
+		int maxX = cardinalClearance[dx > 0 ? 0 : 1];
+		int maxY = cardinalClearance[dy > 0 ? 2 : 3];
+
+		const int diagonalClearance = Clearance(a_x, a_y, dx, dy, hitSubgoal);
+
+		if (hitSubgoal)
+		{
+			m_Reachable.push_back(m_Mask.CellIndex(a_x + (diagonalClearance + 1) * dx, a_y + (diagonalClearance + 1) * dy));
+		}
+
+		for (int i = 1; i <= diagonalClearance; ++i)
+		{
+			const int x = a_x + i * dx;
+			const int y = a_y + i * dy;
+
+			int j = Clearance(x, y, dx, 0, hitSubgoal);
+
+			if (j <= maxX && hitSubgoal)
+			{
+				m_Reachable.push_back(m_Mask.CellIndex(x + (j + 1) * dx, y));
+				--j;
+			}
+
+			maxX = std::min(maxX, j);
+
+			j = Clearance(x, y, 0, dy, hitSubgoal);
+
+			if (j <= maxY && hitSubgoal)
+			{
+				m_Reachable.push_back(m_Mask.CellIndex(x, y + (j + 1) * dy));
+				--j;
+			}
+
+			maxY = std::min(maxY, j);
+		}
+	}
+}
+
+bool SubgoalGraph::TraceDiagonalFirst(int a_fromCell, int a_toCell, std::vector<int>* a_cells) const
+{
+	int x = a_fromCell % m_Mask.Width();
+	int y = a_fromCell / m_Mask.Width();
+	const int toX = a_toCell % m_Mask.Width();
+	const int toY = a_toCell / m_Mask.Width();
+
+	while (x != toX || y != toY)
+	{
+		const int dx = Sign(toX - x);
+		const int dy = Sign(toY - y);
+
+		if (!CanStep(x, y, dx, dy))
+		{
+			return false;
+		}
+
+		x += dx;
+		y += dy;
+
+		if (a_cells)
+		{
+			a_cells->push_back(m_Mask.CellIndex(x, y));
+		}
+	}
+
+	return true;
+}
+
+void SubgoalGraph::AppendSegment(int a_fromCell, int a_toCell, std::vector<int>& a_cellPath)
+{
+	//An edge was found from one of its ends, so the diagonal-first walk is free from at least one of them
+	if (TraceDiagonalFirst(a_fromCell, a_toCell, nullptr))
+	{
+		TraceDiagonalFirst(a_fromCell, a_toCell, &a_cellPath);
+		return;
+	}
+
+	m_Segment.clear();
+	TraceDiagonalFirst(a_toCell, a_fromCell, &m_Segment);
+
+	//m_Segment runs toward a_fromCell and ends on it: skip that, reverse the rest, then finish on a_toCell
+	for (int i = (int)m_Segment.size() - 2; i >= 0; --i)
+	{
+		a_cellPath.push_back(m_Segment[i]);
+	}
+
+	a_cellPath.push_back(a_toCell);
+}
+
+bool SubgoalGraph::FindPath(int a_startX, int a_startY, int a_goalX, int a_goalY, std::vector<int>& a_cellPath)
+{
+	a_cellPath.clear();
+	m_LastPathCost = 0.f;
+
+	if (!m_Mask.IsWalkable(a_startX, a_startY) || !m_Mask.IsWalkable(a_goalX, a_goalY))
+	{
+		return false;
+	}
+
+	const int startCell = m_Mask.CellIndex(a_startX, a_startY);
+	const int goalCell = m_Mask.CellIndex(a_goalX, a_goalY);
+
+	if (startCell == goalCell)
+	{
+		a_cellPath.push_back(startCell);
+		return true;
+	}
+
+	//Start and goal count as subgoals while the query runs, so either can be found directly from the other
+	const bool startIsSubgoal = m_IsSubgoal.Test(startCell);
+	const bool goalIsSubgoal = m_IsSubgoal.Test(goalCell);
+
+	m_IsSubgoal.Set(startCell);
+	m_IsSubgoal.Set(goalCell);
+
+	const int goalNode = goalIsSubgoal ? m_NodeOfCell[goalCell] : AddNodeForCell(goalCell);
+	const int startNode = startIsSubgoal ? m_NodeOfCell[startCell] : AddNodeForCell(startCell);
+
+	if (!goalIsSubgoal)
+	{
+		ConnectToReachable(goalNode, a_goalX, a_goalY);
+	}
+	if (!startIsSubgoal)
+	{
+		ConnectToReachable(startNode, a_startX, a_startY);
+	}
+
+	Graph_SearchAStar<GraphType, Heuristic_Octile> search(m_Graph, startNode, goalNode);
+	search.GetPathToTarget(m_NodePath);
+
+	if (!m_NodePath.empty())
+	{
+		m_LastPathCost = search.GetCostToTarget();
+
+		a_cellPath.push_back(startCell);
+
+		for (size_t i = 1; i < m_NodePath.size(); ++i)
+		{
+			const DirectX::XMFLOAT3& from = m_Graph.GetNode(m_NodePath[i - 1]).GetPositionF3();
+			const DirectX::XMFLOAT3& to = m_Graph.GetNode(m_NodePath[i]).GetPositionF3();
+
+			AppendSegment(m_Mask.CellIndex((int)from.x, (int)from.z), m_Mask.CellIndex((int)to.x, (int)to.z), a_cellPath);
+		}
+	}
+
+	//Take the temporary nodes back out; RemoveNode also drops their edges and frees the slots for the next query
+	if (!startIsSubgoal)
+	{
+		m_Graph.RemoveNode(startNode);
+		m_NodeOfCell[startCell] = invalid_node_index;
+		m_IsSubgoal.Reset(startCell);
+	}
+	if (!goalIsSubgoal)
+	{
+		m_Graph.RemoveNode(goalNode);
+		m_NodeOfCell[goalCell] = invalid_node_index;
+		m_IsSubgoal.Reset(goalCell);
+	}
+
+	return !a_cellPath.empty();
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <AI/Pathfinding/Bitset.h>
+#include <AI/Pathfinding/GridMask.h>
+#include <AI/Pathfinding/NavGraphTypes.h>
+#include <AI/Pathfinding/SparseGraph.h>
+
+#include <vector>
+
+//Simple subgoal graph over an 8-connected grid without corner cutting. Subgoals are placed at the convex corners of
+//obstacles and joined when one is directly h-reachable from the other (an octile-distance path of diagonal then
+//cardinal moves exists that passes no other subgoal). A query links the start and goal cells into this small graph
+//through temporary nodes, runs Graph_SearchAStar over it and expands the subgoal path back into cells.
+//Node positions are cell coordinates (x, 0, y), so edge costs and Heuristic_Octile are in cells.
+class SubgoalGraph
+{
+public:
+	typedef SparseGraph<NavNode, NavEdge> GraphType;
+
+	explicit SubgoalGraph(const GridMask& a_mask);
+
+	//Rebuilds subgoals and edges, e.g. after the mask has changed
+	void Build();
+
+	//Writes the cells (y * width + x) from start to goal into a_cellPath. Returns false if there is no path.
+	bool FindPath(int a_startX, int a_startY, int a_goalX, int a_goalY, std::vector<int>& a_cellPath);
+	float GetLastPathCost() const { return m_LastPathCost; }
+
+	const GraphType& GetGraph() const { return m_Graph; }
+	int NumSubgoals() const { return m_NumSubgoals; }
+	bool IsSubgoal(int a_x, int a_y) const { return m_IsSubgoal.Test(m_Mask.CellIndex(a_x, a_y)); }
+private:
+	SubgoalGraph(const SubgoalGraph&);
+	SubgoalGraph& operator=(const SubgoalGraph&);
+
+	bool CanStep(int a_x, int a_y, int a_dx, int a_dy) const;
+	//Steps taken from (a_x, a_y) before the next step would be blocked or land on a subgoal; a_hitSubgoal says which
+	int Clearance(int a_x, int a_y, int a_dx, int a_dy, bool& a_hitSubgoal) const;
+	//Fills m_Reachable with the cells of subgoals directly h-reachable from (a_x, a_y)
+	void FindDirectHReachable(int a_x, int a_y);
+
+	int AddNodeForCell(int a_cell);
+	void ConnectToReachable(int a_node, int a_x, int a_y);
+	void AppendSegment(int a_fromCell, int a_toCell, std::vector<int>& a_cellPath);
+	bool TraceDiagonalFirst(int a_fromCell, int a_toCell, std::vector<int>* a_cells) const;
+
+	const GridMask& m_Mask;
+	GraphType m_Graph;
+	Bitset m_IsSubgoal; //Per cell; start and goal are flagged for the duration of a query
+	std::vector<int> m_NodeOfCell; //invalid_node_index for cells that are not subgoals
+	std::vector<int> m_Reachable; //Scratch for FindDirectHReachable
+	std::vector<int> m_NodePath; //Scratch for the subgoal level path
+	std::vector<int> m_Segment; //Scratch for reversed segments
+	int m_NumSubgoals;
+	float m_LastPathCost;
+};
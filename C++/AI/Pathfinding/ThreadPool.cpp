@@ -0,0 +1,127 @@
+#include <AI/Pathfinding/ThreadPool.h>
+
+ThreadPool::ThreadPool(int a_numThreads)
+	: m_Function(nullptr)
+	, m_Count(0)
+	, m_ChunkSize(1)
+	, m_NextChunkStart(0)
+	, m_ChunksInFlight(0)
+	, m_Generation(0)
+	, m_Quit(false)
+{
+	if (a_numThreads <= 0)
+	{
+		a_numThreads = (int)std::thread::hardware_concurrency();
+	}
+
+	for (int i = 1; i < a_numThreads; ++i) //The calling thread is the remaining worker
+	{
+		m_Workers.push_back(std::thread(&ThreadPool::WorkerLoop, this));
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_Quit = true;
+	}
+
+	m_WorkReady.notify_all();
+
+	for (size_t i = 0; i < m_Workers.size(); ++i)
+	{
+		m_Workers[i].join();
+	}
+}
+
+ThreadPool& ThreadPool::Get()
+{
+	static ThreadPool pool;
+	return pool;
+}
+
+void ThreadPool::ParallelFor(int a_count, int a_chunkSize, const std::function<void(int, int)>& a_function)
+{
+	if (a_count <= 0)
+	{
+		return;
+	}
+
+	if (a_chunkSize < 1)
+	{
+		a_chunkSize = 1;
+	}
+
+	//Not worth waking anyone for a single chunk
+	if (m_Workers.empty() || a_count <= a_chunkSize)
+	{
+		a_function(0, a_count);
+		return;
+	}
+
+	std::lock_guard<std::mutex> callLock(m_CallMutex);
+	std::unique_lock<std::mutex> lock(m_Mutex);
+
+	m_Function = &a_function;
+	m_Count = a_count;
+	m_ChunkSize = a_chunkSize;
+	m_NextChunkStart = 0;
+	m_ChunksInFlight = 0;
+	++m_Generation;
+
+	m_WorkReady.notify_all();
+
+	while (RunNextChunk(lock)) {}
+
+	m_WorkDone.wait(lock, [this]() { return m_ChunksInFlight == 0; });
+
+	m_Function = nullptr;
+}
+
+void ThreadPool::WorkerLoop()
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	unsigned int lastGeneration = m_Generation;
+
+	while (true)
+	{
+		m_WorkReady.wait(lock, [&]() { return m_Quit || (m_Generation != lastGeneration && m_Function); });
+
+		if (m_Quit)
+		{
+			return;
+		}
+
+		lastGeneration = m_Generation;
+
+		while (RunNextChunk(lock)) {}
+	}
+}
+
+//Takes the next chunk and runs it with the lock released. Returns false once no chunks are left.
+bool ThreadPool::RunNextChunk(std::unique_lock<std::mutex>& a_lock)
+{
+	if (!m_Function || m_NextChunkStart >= m_Count)
+	{
+		return false;
+	}
+
+	int begin = m_NextChunkStart;
+	int end = (m_Count - begin > m_ChunkSize) ? begin + m_ChunkSize : m_Count;
+	m_NextChunkStart = end;
+	++m_ChunksInFlight;
+
+	const std::function<void(int, int)>& function = *m_Function;
+
+	a_lock.unlock();
+	function(begin, end);
+	a_lock.lock();
+
+	if (--m_ChunksInFlight == 0 && m_NextChunkStart >= m_Count)
+	{
+		m_WorkDone.notify_all();
+	}
+
+	return true;
+}
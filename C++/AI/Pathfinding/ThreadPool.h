@@ -0,0 +1,45 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Fixed set of worker threads used to split data-parallel work (steering batches, graph searches) into chunks.
+//ParallelFor blocks until every chunk has run; the calling thread works on chunks too.
+class ThreadPool
+{
+public:
+	explicit ThreadPool(int a_numThreads = 0); //0 uses std::thread::hardware_concurrency
+	~ThreadPool();
+
+	int NumThreads() const { return (int)m_Workers.size() + 1; } //Including the calling thread
+
+	//Calls a_function(begin, end) over [0, a_count) in chunks of at most a_chunkSize items.
+	//Calls from different threads are serialised; calling it from inside a chunk will deadlock.
+	void ParallelFor(int a_count, int a_chunkSize, const std::function<void(int, int)>& a_function);
+
+	//Process wide pool, created on first use
+	static ThreadPool& Get();
+private:
+	ThreadPool(const ThreadPool&);
+	ThreadPool& operator=(const ThreadPool&);
+
+	void WorkerLoop();
+	bool RunNextChunk(std::unique_lock<std::mutex>& a_lock);
+
+	std::vector<std::thread> m_Workers;
+	std::mutex m_CallMutex; //Held for the whole of a ParallelFor
+	std::mutex m_Mutex;
+	std::condition_variable m_WorkReady;
+	std::condition_variable m_WorkDone;
+
+	const std::function<void(int, int)>* m_Function;
+	int m_Count;
+	int m_ChunkSize;
+	int m_NextChunkStart;
+	int m_ChunksInFlight;
+	unsigned int m_Generation;
+	bool m_Quit;
+};
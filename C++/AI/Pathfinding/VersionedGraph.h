@@ -0,0 +1,567 @@
+#pragma once
+
+#include <AI/Pathfinding/NodeTypeEnumerations.h>
+#include <AI/Pathfinding/SparseGraph.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+//Graph that one writer thread edits while any number of reader threads search published versions of it.
+//
+//Node slots are grouped into chunks of 64, each holding its nodes, an active bit per slot and its edges as a small CSR
+//array. A published Snapshot is an immutable table of chunk pointers with the read interface of SparseGraph, so any of
+//the Graph_Search classes can run on it. Edits go to a pending version; the first edit to a chunk after a Publish()
+//copies just that chunk, and Publish() makes the pending chunk table the new current version with one atomic pointer
+//swap. Readers take a SnapshotPtr with GetSnapshot() and search it with no locks; a superseded version and any chunks
+//no longer shared with newer ones are freed when the last reader holding it lets go (reference counted grace period).
+//
+//  VersionedGraph<NavNode, NavEdge>::SnapshotPtr view = graph.GetSnapshot();
+//  Graph_SearchAStar<VersionedGraph<NavNode, NavEdge>::Snapshot, Heuristic_Euclidean> search(*view, source, target);
+//
+//Keep the SnapshotPtr alive for as long as the search object, which holds a reference to the snapshot.
+template <class node_type, class edge_type>
+class VersionedGraph
+{
+private:
+	static const int k_ChunkShift = 6;
+	static const int k_ChunkSize = 1 << k_ChunkShift;
+	static const int k_ChunkMask = k_ChunkSize - 1;
+
+	struct Chunk
+	{
+		std::vector<node_type> nodes; //Up to k_ChunkSize slots, only the last chunk is partly filled
+		std::vector<int> edgeStart; //Edges of slot i are edges[edgeStart[i] .. edgeStart[i + 1])
+		std::vector<edge_type> edges;
+		uint64_t active; //Bit per slot, set while the node is active
+	};
+
+	typedef std::shared_ptr<Chunk> ChunkPtr;
+public:
+	typedef edge_type EdgeType;
+	typedef node_type NodeType;
+
+	//One version of the graph. Published snapshots never change.
+	class Snapshot
+	{
+	public:
+		typedef edge_type EdgeType;
+		typedef node_type NodeType;
+
+		//Returns the number of active + inactive nodes present in the graph
+		int NumNodes() const { return m_NumNodes; }
+		int NumActiveNodes() const { return m_NumActiveNodes; }
+		int NumEdges() const { return m_NumEdges; }
+		bool isDigraph() const { return m_bDigraph; }
+		bool isEmpty() const { return m_NumNodes == 0; }
+
+		//Number of Publish() calls before this version was taken
+		unsigned GetVersion() const { return m_Version; }
+
+		bool isNodePresent(int a_node) const
+		{
+			return a_node >= 0 && a_node < m_NumNodes && (ChunkOf(a_node).active >> (a_node & k_ChunkMask) & 1) != 0;
+		}
+
+		bool isEdgePresent(int a_from, int a_to) const
+		{
+			return isNodePresent(a_from) && isNodePresent(a_to) && FindEdge(a_from, a_to) != NULL;
+		}
+
+		const NodeType& GetNode(int a_node) const
+		{
+			assert(a_node >= 0 && a_node < m_NumNodes && "<VersionedGraph::Snapshot::GetNode>: invalid index");
+
+			return ChunkOf(a_node).nodes[a_node & k_ChunkMask];
+		}
+
+		const EdgeType& GetEdge(int a_from, int a_to) const
+		{
+			assert(isNodePresent(a_from) && isNodePresent(a_to) && "<VersionedGraph::Snapshot::GetEdge>: invalid index");
+
+			const EdgeType* edge = FindEdge(a_from, a_to);
+
+			assert(edge && "<VersionedGraph::Snapshot::GetEdge>: edge does not exist");
+
+			return *edge;
+		}
+
+		//Same protocol as SparseGraph::ConstEdgeIterator. A node's edges are contiguous, so this is a pointer walk.
+		class ConstEdgeIterator
+		{
+		private:
+			const EdgeType* curEdge;
+			const EdgeType* firstEdge;
+			const EdgeType* lastEdge;
+		public:
+			ConstEdgeIterator(const Snapshot& graph, int node)
+			{
+				const Chunk& chunk = graph.ChunkOf(node);
+				const int slot = node & k_ChunkMask;
+
+				firstEdge = chunk.edges.data() + chunk.edgeStart[slot];
+				lastEdge = chunk.edges.data() + chunk.edgeStart[slot + 1];
+				curEdge = firstEdge;
+			}
+
+			const EdgeType* begin()
+			{
+				curEdge = firstEdge;
+
+				return end() ? NULL : curEdge;
+			}
+
+			const EdgeType* next()
+			{
+				++curEdge;
+
+				return end() ? NULL : curEdge;
+			}
+
+			bool end() { return curEdge == lastEdge; }
+		};
+
+		//Visits the active nodes in index order
+		class ConstNodeIterator
+		{
+		private:
+			const Snapshot& G;
+			int curNode;
+
+			void GetNextValidNode()
+			{
+				while (curNode < G.m_NumNodes && !G.isNodePresent(curNode))
+				{
+					++curNode;
+				}
+			}
+		public:
+			ConstNodeIterator(const Snapshot& graph) : G(graph), curNode(0) { GetNextValidNode(); }
+
+			const NodeType* begin()
+			{
+				curNode = 0;
+				GetNextValidNode();
+
+				return end() ? NULL : &G.GetNode(curNode);
+			}
+
+			const NodeType* next()
+			{
+				++curNode;
+				GetNextValidNode();
+
+				return end() ? NULL : &G.GetNode(curNode);
+			}
+
+			bool end() { return curNode >= G.m_NumNodes; }
+		};
+	private:
+		friend class VersionedGraph;
+
+		explicit Snapshot(bool a_digraph) : m_NumNodes(0), m_NumActiveNodes(0), m_NumEdges(0), m_bDigraph(a_digraph), m_Version(0) {}
+
+		const Chunk& ChunkOf(int a_node) const { return *m_Chunks[a_node >> k_ChunkShift]; }
+
+		const EdgeType* FindEdge(int a_from, int a_to) const
+		{
+			ConstEdgeIterator ConstEdgeItr(*this, a_from);
+
+			for (const EdgeType* e = ConstEdgeItr.begin(); !ConstEdgeItr.end(); e = ConstEdgeItr.next())
+			{
+				if (e->To() == a_to)
+				{
+					return e;
+				}
+			}
+
+			return NULL;
+		}
+
+		std::vector<ChunkPtr> m_Chunks; //Shared between versions, only written by the writer before they are published
+		int m_NumNodes;
+		int m_NumActiveNodes;
+		int m_NumEdges;
+		bool m_bDigraph;
+		unsigned m_Version;
+	};
+
+	typedef std::shared_ptr<const Snapshot> SnapshotPtr;
+
+	//As SparseGraph, an undirected (digraph == false) graph stores every edge in both directions. Publishes an empty
+	//version 0.
+	explicit VersionedGraph(bool digraph);
+
+	//Copies a graph, keeping its node indices, removed slots and free list (so placeholder slots stay off it), and
+	//publishes the copy as version 0
+	explicit VersionedGraph(const SparseGraph<node_type, edge_type>& graph);
+
+	//Reader side, safe from any thread: the most recently published version
+	SnapshotPtr GetSnapshot() const { return std::atomic_load(&m_Published); }
+
+	//Writer side, from one thread at a time. Edits follow the SparseGraph methods of the same names and are only seen
+	//by readers after the next Publish().
+	int GetNextFreeNodeIndex() const { return m_FreeNodeIndices.empty() ? m_Pending.m_NumNodes : m_FreeNodeIndices.back(); }
+	int AddNode(node_type node);
+	void RemoveNode(int node);
+	void AddEdge(EdgeType edge);
+	void RemoveEdge(int from, int to);
+	void SetEdgeCost(int from, int to, double cost);
+
+	//As SparseGraph::Reorder. Rewrites every chunk, so the next Publish() shares nothing with earlier versions.
+	std::vector<int> Reorder(const std::vector<int>& newIndexOfOld);
+
+	//The pending version including unpublished edits, for the writer to read back
+	const Snapshot& GetPending() const { return m_Pending; }
+
+	//Makes the pending edits visible to readers and returns the new version
+	SnapshotPtr Publish();
+private:
+	VersionedGraph(const VersionedGraph&);
+	VersionedGraph& operator=(const VersionedGraph&);
+
+	Chunk& WriteChunk(int a_node);
+	int AppendSlot(const node_type& a_node, bool a_active);
+	void InsertEdge(const EdgeType& a_edge);
+	bool EraseEdge(int a_from, int a_to);
+
+	Snapshot m_Pending;
+	std::vector<char> m_Owned; //Chunks of m_Pending copied (or created) since the last Publish(), writable in place
+	std::vector<int> m_FreeNodeIndices;
+	std::vector<int> m_Neighbours; //Scratch for RemoveNode
+	SnapshotPtr m_Published;
+};
+
+template <class node_type, class edge_type>
+VersionedGraph<node_type, edge_type>::VersionedGraph(bool digraph)
+	: m_Pending(digraph)
+{
+	Publish();
+}
+
+template <class node_type, class edge_type>
+VersionedGraph<node_type, edge_type>::VersionedGraph(const SparseGraph<node_type, edge_type>& graph)
+	: m_Pending(graph.isDigraph())
+{
+	for (int n = 0; n < graph.NumNodes(); ++n)
+	{
+		AppendSlot(graph.GetNode(n), graph.isNodePresent(n));
+	}
+
+	m_FreeNodeIndices = graph.GetFreeNodeIndices();
+
+	for (int n = 0; n < graph.NumNodes(); ++n)
+	{
+		if (!graph.isNodePresent(n))
+		{
+			continue;
+		}
+
+		typename SparseGraph<node_type, edge_type>::ConstEdgeIterator ConstEdgeItr(graph, n);
+
+		for (const edge_type* e = ConstEdgeItr.begin(); !ConstEdgeItr.end(); e = ConstEdgeItr.next())
+		{
+			InsertEdge(*e);
+		}
+	}
+
+	Publish();
+}
+
+//Copy on write: the first write to a chunk after a Publish() gives the pending version its own copy, leaving the
+//published versions sharing the original
+template <class node_type, class edge_type>
+typename VersionedGraph<node_type, edge_type>::Chunk& VersionedGraph<node_type, edge_type>::WriteChunk(int a_node)
+{
+	const int chunk = a_node >> k_ChunkShift;
+
+	if (!m_Owned[chunk])
+	{
+		m_Pending.m_Chunks[chunk] = std::make_shared<Chunk>(*m_Pending.m_Chunks[chunk]);
+		m_Owned[chunk] = 1;
+	}
+
+	return *m_Pending.m_Chunks[chunk];
+}
+
+template <class node_type, class edge_type>
+int VersionedGraph<node_type, edge_type>::AppendSlot(const node_type& a_node, bool a_active)
+{
+	const int index = m_Pending.m_NumNodes;
+
+	if ((index & k_ChunkMask) == 0)
+	{
+		ChunkPtr chunk = std::make_shared<Chunk>();
+		chunk->nodes.reserve(k_ChunkSize);
+		chunk->edgeStart.reserve(k_ChunkSize + 1);
+		chunk->edgeStart.push_back(0);
+		chunk->active = 0;
+
+		m_Pending.m_Chunks.push_back(chunk);
+		m_Owned.push_back(1);
+	}
+
+	Chunk& chunk = WriteChunk(index);
+	chunk.nodes.push_back(a_node);
+	chunk.edgeStart.push_back(chunk.edgeStart.back());
+
+	if (a_active)
+	{
+		chunk.active |= uint64_t(1) << (index & k_ChunkMask);
+		++m_Pending.m_NumActiveNodes;
+	}
+
+	++m_Pending.m_NumNodes;
+
+	return index;
+}
+
+template <class node_type, class edge_type>
+int VersionedGraph<node_type, edge_type>::AddNode(node_type node)
+{
+	if (node.Index() < m_Pending.m_NumNodes)
+	{
+		assert(!m_Pending.isNodePresent(node.Index()) && "<VersionedGraph::AddNode>: Attempting to add a node with a duplicate ID");
+
+		Chunk& chunk = WriteChunk(node.Index());
+		chunk.nodes[node.Index() & k_ChunkMask] = node;
+		chunk.active |= uint64_t(1) << (node.Index() & k_ChunkMask);
+		++m_Pending.m_NumActiveNodes;
+
+		std::vector<int>::iterator freeSlot = std::find(m_FreeNodeIndices.begin(), m_FreeNodeIndices.end(), node.Index());
+
+		if (freeSlot != m_FreeNodeIndices.end())
+		{
+			*freeSlot = m_FreeNodeIndices.back();
+			m_FreeNodeIndices.pop_back();
+		}
+
+		return node.Index();
+	}
+
+	assert(node.Index() == m_Pending.m_NumNodes && "<VersionedGraph::AddNode>: invalid index");
+
+	return AppendSlot(node, true);
+}
+
+//As SparseGraph::RemoveNode: the edges back from the node's neighbours go with it, and its slot is reused by AddNode
+template <class node_type, class edge_type>
+void VersionedGraph<node_type, edge_type>::RemoveNode(int node)
+{
+	assert(node >= 0 && node < m_Pending.m_NumNodes && "<VersionedGraph::RemoveNode>: invalid node index");
+
+	if (!m_Pending.isNodePresent(node))
+	{
+		return;
+	}
+
+	m_Neighbours.clear();
+
+	typename Snapshot::ConstEdgeIterator ConstEdgeItr(m_Pending, node);
+
+	for (const EdgeType* e = ConstEdgeItr.begin(); !ConstEdgeItr.end(); e = ConstEdgeItr.next())
+	{
+		m_Neighbours.push_back(e->To());
+	}
+
+	for (size_t i = 0; i < m_Neighbours.size(); ++i)
+	{
+		EraseEdge(m_Neighbours[i], node);
+	}
+
+	Chunk& chunk = WriteChunk(node);
+	const int slot = node & k_ChunkMask;
+	const int numEdges = chunk.edgeStart[slot + 1] - chunk.edgeStart[slot];
+
+	chunk.edges.erase(chunk.edges.begin() + chunk.edgeStart[slot], chunk.edges.begin() + chunk.edgeStart[slot + 1]);
+
+	for (int s = slot + 1; s < (int)chunk.edgeStart.size(); ++s)
+	{
+		chunk.edgeStart[s] -= numEdges;
+	}
+
+	m_Pending.m_NumEdges -= numEdges;
+
+	chunk.nodes[slot].SetIndex(invalid_node_index);
+	chunk.active &= ~(uint64_t(1) << slot);
+	--m_Pending.m_NumActiveNodes;
+	m_FreeNodeIndices.push_back(node);
+}
+
+template <class node_type, class edge_type>
+void VersionedGraph<node_type, edge_type>::InsertEdge(const EdgeType& a_edge)
+{
+	Chunk& chunk = WriteChunk(a_edge.From());
+	const int slot = a_edge.From() & k_ChunkMask;
+
+	chunk.edges.insert(chunk.edges.begin() + chunk.edgeStart[slot + 1], a_edge);
+
+	for (int s = slot + 1; s < (int)chunk.edgeStart.size(); ++s)
+	{
+		++chunk.edgeStart[s];
+	}
+
+	++m_Pending.m_NumEdges;
+}
+
+//Returns false (and leaves the chunk shared) if there was no such edge
+template <class node_type, class edge_type>
+bool VersionedGraph<node_type, edge_type>::EraseEdge(int a_from, int a_to)
+{
+	const EdgeType* edge = m_Pending.FindEdge(a_from, a_to);
+
+	if (!edge)
+	{
+		return false;
+	}
+
+	const Chunk& shared = m_Pending.ChunkOf(a_from);
+	const int position = (int)(edge - shared.edges.data());
+
+	Chunk& chunk = WriteChunk(a_from);
+	const int slot = a_from & k_ChunkMask;
+
+	chunk.edges.erase(chunk.edges.begin() + position);
+
+	for (int s = slot + 1; s < (int)chunk.edgeStart.size(); ++s)
+	{
+		--chunk.edgeStart[s];
+	}
+
+	--m_Pending.m_NumEdges;
+
+	return true;
+}
+
+template <class node_type, class edge_type>
+void VersionedGraph<node_type, edge_type>::AddEdge(EdgeType edge)
+{
+	assert(edge.From() < m_Pending.m_NumNodes && edge.To() < m_Pending.m_NumNodes && "<VersionedGraph::AddEdge>: invalid node index");
+
+	if (!m_Pending.isNodePresent(edge.From()) || !m_Pending.isNodePresent(edge.To()))
+	{
+		return;
+	}
+
+	if (!m_Pending.FindEdge(edge.From(), edge.To()))
+	{
+		InsertEdge(edge);
+	}
+
+	//if the graph is undirected we must add another connection in the opposite direction
+	if (!m_Pending.m_bDigraph && !m_Pending.FindEdge(edge.To(), edge.From()))
+	{
+		EdgeType NewEdge = edge;
+
+		NewEdge.SetTo(edge.From());
+		NewEdge.SetFrom(edge.To());
+
+		InsertEdge(NewEdge);
+	}
+}
+
+template <class node_type, class edge_type>
+void VersionedGraph<node_type, edge_type>::RemoveEdge(int from, int to)
+{
+	assert(from < m_Pending.m_NumNodes && to < m_Pending.m_NumNodes && "<VersionedGraph::RemoveEdge>: invalid node index");
+
+	if (!m_Pending.m_bDigraph)
+	{
+		EraseEdge(to, from);
+	}
+
+	EraseEdge(from, to);
+}
+
+template <class node_type, class edge_type>
+void VersionedGraph<node_type, edge_type>::SetEdgeCost(int from, int to, double cost)
+{
+	assert(from < m_Pending.m_NumNodes && to < m_Pending.m_NumNodes && "<VersionedGraph::SetEdgeCost>: invalid index");
+
+	const EdgeType* edge = m_Pending.FindEdge(from, to);
+
+	if (!edge)
+	{
+		return;
+	}
+
+	//the edge's position within its chunk survives the copy
+	const int position = (int)(edge - m_Pending.ChunkOf(from).edges.data());
+
+	WriteChunk(from).edges[position].SetCost(cost);
+}
+
+template <class node_type, class edge_type>
+std::vector<int> VersionedGraph<node_type, edge_type>::Reorder(const std::vector<int>& newIndexOfOld)
+{
+	assert((int)newIndexOfOld.size() == m_Pending.m_NumNodes && "<VersionedGraph::Reorder>: the table must cover every node slot");
+
+	std::vector<int> oldIndexOfNew(newIndexOfOld.size(), invalid_node_index);
+
+	for (int n = 0; n < (int)newIndexOfOld.size(); ++n)
+	{
+		assert(newIndexOfOld[n] >= 0 && newIndexOfOld[n] < (int)newIndexOfOld.size() && "<VersionedGraph::Reorder>: new index out of range");
+		assert(oldIndexOfNew[newIndexOfOld[n]] == invalid_node_index && "<VersionedGraph::Reorder>: the table is not a permutation");
+
+		oldIndexOfNew[newIndexOfOld[n]] = n;
+	}
+
+	const Snapshot old(m_Pending);
+
+	m_Pending.m_Chunks.clear();
+	m_Pending.m_NumNodes = 0;
+	m_Pending.m_NumActiveNodes = 0;
+	m_Pending.m_NumEdges = 0;
+	m_Owned.clear();
+
+	for (std::vector<int>::iterator freeSlot = m_FreeNodeIndices.begin(); freeSlot != m_FreeNodeIndices.end(); ++freeSlot)
+	{
+		*freeSlot = newIndexOfOld[*freeSlot];
+	}
+
+	for (int n = 0; n < old.m_NumNodes; ++n)
+	{
+		node_type node = old.GetNode(oldIndexOfNew[n]);
+		const bool active = old.isNodePresent(oldIndexOfNew[n]);
+
+		if (active)
+		{
+			node.SetIndex(n);
+		}
+
+		AppendSlot(node, active);
+	}
+
+	for (int n = 0; n < old.m_NumNodes; ++n)
+	{
+		typename Snapshot::ConstEdgeIterator ConstEdgeItr(old, oldIndexOfNew[n]);
+
+		for (const EdgeType* e = ConstEdgeItr.begin(); !ConstEdgeItr.end(); e = ConstEdgeItr.next())
+		{
+			EdgeType edge = *e;
+
+			edge.SetFrom(n);
+			edge.SetTo(newIndexOfOld[e->To()]);
+
+			InsertEdge(edge);
+		}
+	}
+
+	return oldIndexOfNew;
+}
+
+template <class node_type, class edge_type>
+typename VersionedGraph<node_type, edge_type>::SnapshotPtr VersionedGraph<node_type, edge_type>::Publish()
+{
+	//the copy shares every chunk with the pending version; clearing m_Owned makes the next write to any of them copy it
+	SnapshotPtr snapshot(new Snapshot(m_Pending));
+
+	std::atomic_store(&m_Published, snapshot);
+
+	std::fill(m_Owned.begin(), m_Owned.end(), 0);
+	++m_Pending.m_Version;
+
+	return snapshot;
+}